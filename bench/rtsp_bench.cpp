@@ -0,0 +1,343 @@
+// rtsp_bench — microbenchmarks for the receiver's hot paths.
+//
+//   rtsp_bench [--model=path.tflite] [google-benchmark flags]
+//
+// JSON output for regression tracking across releases:
+//   rtsp_bench --benchmark_out=rtsp_bench.json --benchmark_out_format=json
+//
+// Renderer benchmarks need a display (GLFW window); they report an error and
+// are skipped when none is available. Backend benchmarks run once per
+// BackendRegistry entry (BM_BackendProcess/<name>/<size>, so e.g.
+// --benchmark_filter=BM_BackendProcess/cpu compares the CPU variants side by
+// side) on a tiny generated model (uint8 → float32 CAST) unless --model or
+// RTSP_BENCH_MODEL points at a real .tflite file.
+
+#include <benchmark/benchmark.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include "backend_registry.h"
+#include "stream_discovery.h"
+#include "video_renderer.h"
+
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Shared state (created on the main thread before any benchmark runs)
+// ---------------------------------------------------------------------------
+
+static constexpr int kRendererSlots = 16;
+
+static std::unique_ptr<VideoRenderer> g_renderer;
+static std::string                    g_model_path;
+
+static std::vector<uint8_t> make_rgb_frame(int width, int height) {
+    std::vector<uint8_t> frame(static_cast<size_t>(width) * height * 3);
+    for (size_t i = 0; i < frame.size(); ++i)
+        frame[i] = static_cast<uint8_t>(i * 31u);
+    return frame;
+}
+
+// ---------------------------------------------------------------------------
+// Bundled tiny model: one CAST op, uint8 [1,H,W,3] → float32 [1,H,W,3].
+// Exercises the full CpuBackend input copy / Invoke / output path without
+// shipping a binary .tflite in the repo.
+// ---------------------------------------------------------------------------
+
+static std::string write_tiny_model(int width, int height) {
+    flatbuffers::FlatBufferBuilder fbb;
+
+    std::vector<flatbuffers::Offset<tflite::Buffer>> buffers = {
+        tflite::CreateBuffer(fbb),  // buffer 0: empty sentinel required by the schema
+    };
+
+    const std::vector<int32_t> shape = {1, height, width, 3};
+    std::vector<flatbuffers::Offset<tflite::Tensor>> tensors = {
+        tflite::CreateTensor(fbb, fbb.CreateVector(shape), tflite::TensorType_UINT8,
+                             0, fbb.CreateString("input")),
+        tflite::CreateTensor(fbb, fbb.CreateVector(shape), tflite::TensorType_FLOAT32,
+                             0, fbb.CreateString("output")),
+    };
+
+    const std::vector<int32_t> inputs  = {0};
+    const std::vector<int32_t> outputs = {1};
+    std::vector<flatbuffers::Offset<tflite::Operator>> ops = {
+        tflite::CreateOperator(fbb, 0, fbb.CreateVector(inputs), fbb.CreateVector(outputs)),
+    };
+
+    std::vector<flatbuffers::Offset<tflite::SubGraph>> subgraphs = {
+        tflite::CreateSubGraph(fbb, fbb.CreateVector(tensors),
+                               fbb.CreateVector(inputs), fbb.CreateVector(outputs),
+                               fbb.CreateVector(ops), fbb.CreateString("main")),
+    };
+
+    std::vector<flatbuffers::Offset<tflite::OperatorCode>> opcodes = {
+        tflite::CreateOperatorCode(fbb, static_cast<int8_t>(tflite::BuiltinOperator_CAST),
+                                   0, 1, tflite::BuiltinOperator_CAST),
+    };
+
+    auto model = tflite::CreateModel(fbb, 3,  // schema version
+                                     fbb.CreateVector(opcodes),
+                                     fbb.CreateVector(subgraphs),
+                                     fbb.CreateString("rtsp_bench tiny model"),
+                                     fbb.CreateVector(buffers));
+    tflite::FinishModelBuffer(fbb, model);
+
+    const std::string path = "/tmp/rtsp_bench_tiny_" + std::to_string(width) + "x" +
+                             std::to_string(height) + ".tflite";
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(fbb.GetBufferPointer()), fbb.GetSize());
+    return out ? path : std::string();
+}
+
+// ---------------------------------------------------------------------------
+// VideoRenderer::push_frame under contention
+//   Arg 0: 0 = every thread hammers slot 0, 1 = one slot per thread
+// ---------------------------------------------------------------------------
+
+static void BM_PushFrame(benchmark::State& state) {
+    if (!g_renderer) {
+        state.SkipWithError("no display: VideoRenderer unavailable");
+        return;
+    }
+    const bool per_thread_slot = state.range(0) != 0;
+    const int  width  = 1280;
+    const int  height = 720;
+    const auto frame  = make_rgb_frame(width, height);
+    const int  slot   = per_thread_slot ? state.thread_index() % kRendererSlots : 0;
+
+    for (auto _ : state)
+        g_renderer->push_frame(slot, frame.data(), width, height);
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size()));
+}
+BENCHMARK(BM_PushFrame)->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
+
+// ---------------------------------------------------------------------------
+// Texture upload: N dirty slots per render() call
+//   Args: {dirty slots, frame height (16:9)}
+// Note: render() ends with glfwSwapBuffers, so results include vsync waits
+// when the driver honours swap interval 1. The upload budget is lifted, but a
+// back texture still being drawn from defers its upload: only uploads that
+// happened count as bytes, and "deferred" reports the rest per render().
+// ---------------------------------------------------------------------------
+
+static void BM_RenderUpload(benchmark::State& state) {
+    if (!g_renderer) {
+        state.SkipWithError("no display: VideoRenderer unavailable");
+        return;
+    }
+    const int dirty  = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    const int width  = height * 16 / 9;
+    const auto frame = make_rgb_frame(width, height);
+    g_renderer->set_upload_budget(0);
+    const uint64_t deferred_before = g_renderer->uploads_deferred();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int i = 0; i < dirty; ++i)
+            g_renderer->push_frame(i, frame.data(), width, height);
+        state.ResumeTiming();
+        g_renderer->render();
+    }
+    // Every render() either uploads a dirty slot or defers it.
+    const int64_t deferred = static_cast<int64_t>(g_renderer->uploads_deferred() - deferred_before);
+    const int64_t uploads  = state.iterations() * dirty - deferred;
+    state.SetBytesProcessed(uploads * static_cast<int64_t>(frame.size()));
+    state.counters["deferred"] = benchmark::Counter(static_cast<double>(deferred) / state.iterations());
+}
+BENCHMARK(BM_RenderUpload)
+    ->Args({1, 480})->Args({1, 1080})
+    ->Args({4, 720})->Args({16, 480})->Args({16, 720})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// ---------------------------------------------------------------------------
+// InferenceBackend::process, one instance per registered backend
+//   Arg 0: square input size of the generated model (ignored with --model)
+// ---------------------------------------------------------------------------
+
+static void BM_BackendProcess(benchmark::State& state, const BackendInfo& info) {
+    const int size = static_cast<int>(state.range(0));
+    const std::string path = g_model_path.empty() ? write_tiny_model(size, size) : g_model_path;
+    if (path.empty()) {
+        state.SkipWithError("failed to write tiny model");
+        return;
+    }
+
+    auto backend = info.factory();
+    backend->set_model(path);
+    if (!backend->prepare()) {
+        state.SkipWithError("prepare failed");
+        return;
+    }
+
+    const auto frame = make_rgb_frame(size, size);
+    for (auto _ : state) {
+        if (!backend->process(frame.data(), size, size)) {
+            state.SkipWithError("process failed");
+            break;
+        }
+        benchmark::DoNotOptimize(backend->output_data(0));
+    }
+    backend->teardown();
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void register_backend_benchmarks() {
+    for (const BackendInfo& info : BackendRegistry::instance().list()) {
+        benchmark::RegisterBenchmark(("BM_BackendProcess/" + info.name).c_str(), BM_BackendProcess, info)
+            ->Arg(224)->Arg(320)->Unit(benchmark::kMicrosecond);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// RGB ↔ YUV conversion (GstVideoConverter, the engine behind videoconvert)
+//   Args: {direction (0 = I420→RGB, 1 = RGB→I420), frame height (16:9)}
+// ---------------------------------------------------------------------------
+
+static void BM_ColorConvert(benchmark::State& state) {
+    const bool to_yuv = state.range(0) != 0;
+    const int  height = static_cast<int>(state.range(1));
+    const int  width  = height * 16 / 9;
+
+    GstVideoInfo rgb_info, yuv_info;
+    gst_video_info_set_format(&rgb_info, GST_VIDEO_FORMAT_RGB,  width, height);
+    gst_video_info_set_format(&yuv_info, GST_VIDEO_FORMAT_I420, width, height);
+    const GstVideoInfo& in_info  = to_yuv ? rgb_info : yuv_info;
+    const GstVideoInfo& out_info = to_yuv ? yuv_info : rgb_info;
+
+    GstVideoConverter* conv = gst_video_converter_new(
+        const_cast<GstVideoInfo*>(&in_info), const_cast<GstVideoInfo*>(&out_info), nullptr);
+    GstBuffer* in_buf  = gst_buffer_new_allocate(nullptr, GST_VIDEO_INFO_SIZE(&in_info),  nullptr);
+    GstBuffer* out_buf = gst_buffer_new_allocate(nullptr, GST_VIDEO_INFO_SIZE(&out_info), nullptr);
+    gst_buffer_memset(in_buf, 0, 0x80, GST_VIDEO_INFO_SIZE(&in_info));
+
+    GstVideoFrame in_frame, out_frame;
+    if (!conv ||
+        !gst_video_frame_map(&in_frame,  const_cast<GstVideoInfo*>(&in_info),  in_buf,  GST_MAP_READ)) {
+        state.SkipWithError("converter setup failed");
+    } else if (!gst_video_frame_map(&out_frame, const_cast<GstVideoInfo*>(&out_info), out_buf, GST_MAP_WRITE)) {
+        gst_video_frame_unmap(&in_frame);
+        state.SkipWithError("converter setup failed");
+    } else {
+        for (auto _ : state)
+            gst_video_converter_frame(conv, &in_frame, &out_frame);
+        gst_video_frame_unmap(&out_frame);
+        gst_video_frame_unmap(&in_frame);
+        state.SetBytesProcessed(state.iterations() *
+                                static_cast<int64_t>(GST_VIDEO_INFO_SIZE(&in_info)));
+    }
+
+    if (conv) gst_video_converter_free(conv);
+    gst_buffer_unref(in_buf);
+    gst_buffer_unref(out_buf);
+}
+BENCHMARK(BM_ColorConvert)
+    ->Args({0, 720})->Args({0, 1080})
+    ->Args({1, 720})->Args({1, 1080})
+    ->Unit(benchmark::kMicrosecond);
+
+// ---------------------------------------------------------------------------
+// Discovery probe throughput against a local TCP listener
+// ---------------------------------------------------------------------------
+
+static void BM_DiscoveryProbe(benchmark::State& state) {
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = 0;  // ephemeral
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd, 512) != 0 ||
+        getsockname(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), &len) != 0) {
+        close(listen_fd);
+        state.SkipWithError("failed to open local listener");
+        return;
+    }
+    const int port = ntohs(addr.sin_port);
+
+    std::atomic<bool> running{true};
+    std::thread acceptor([&] {
+        while (running) {
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0) break;
+            close(fd);
+        }
+    });
+
+    StreamDiscovery discovery;
+    int64_t failures = 0;
+    for (auto _ : state)
+        if (!discovery.probe_rtsp_endpoint("127.0.0.1", port)) ++failures;
+
+    running = false;
+    shutdown(listen_fd, SHUT_RDWR);  // unblocks accept()
+    acceptor.join();
+    close(listen_fd);
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["failures"] = static_cast<double>(failures);
+}
+BENCHMARK(BM_DiscoveryProbe)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    gst_init(&argc, &argv);
+
+    // Strip our own flag before google-benchmark parses the rest.
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a.rfind("--model=", 0) == 0) g_model_path = a.substr(8);
+        else args.push_back(argv[i]);
+    }
+    if (g_model_path.empty())
+        if (const char* env = std::getenv("RTSP_BENCH_MODEL")) g_model_path = env;
+
+    register_backend_benchmarks();
+
+    int bench_argc = static_cast<int>(args.size());
+    benchmark::Initialize(&bench_argc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(bench_argc, args.data())) return 1;
+
+    // The GL context must be current on the thread that calls render(), which
+    // for single-threaded benchmarks is this one.
+    try {
+        g_renderer = std::make_unique<VideoRenderer>(kRendererSlots, "rtsp_bench");
+    } catch (const std::exception& e) {
+        std::cerr << "[rtsp_bench] Renderer benchmarks disabled: " << e.what() << "\n";
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    g_renderer.reset();
+    gst_deinit();
+    return 0;
+}
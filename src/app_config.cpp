@@ -0,0 +1,230 @@
+#include "app_config.h"
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Thrown for semantic errors; caught in load_app_config() next to the
+// parser's own exceptions so both report the same way.
+struct ConfigError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+template <typename T>
+T get_or(const json& j, const char* key, const T& fallback) {
+    auto it = j.find(key);
+    if (it == j.end() || it->is_null()) return fallback;
+    try {
+        return it->get<T>();
+    } catch (const json::exception&) {
+        throw ConfigError(std::string("wrong type for \"") + key + "\"");
+    }
+}
+
+RtspTransport parse_transport(const std::string& s) {
+    if (s == "auto") return RtspTransport::Auto;
+    if (s == "tcp")  return RtspTransport::Tcp;
+    if (s == "udp")  return RtspTransport::Udp;
+    throw ConfigError("transport must be auto, tcp or udp (got \"" + s + "\")");
+}
+
+DecodePolicy parse_decode(const std::string& s) {
+    if (s == "auto")     return DecodePolicy::Auto;
+    if (s == "software") return DecodePolicy::Software;
+    throw ConfigError("decode must be auto or software (got \"" + s + "\")");
+}
+
+ReplayPacing parse_pacing(const std::string& s) {
+    if (s == "realtime") return ReplayPacing::RealTime;
+    if (s == "fast")     return ReplayPacing::AsFastAsPossible;
+    throw ConfigError("pacing must be realtime or fast (got \"" + s + "\")");
+}
+
+int latency_for_profile(const std::string& s) {
+    if (s == "low")      return 100;
+    if (s == "balanced") return 500;
+    if (s == "robust")   return 2000;
+    throw ConfigError("latency_profile must be low, balanced or robust (got \"" + s + "\")");
+}
+
+// Apply every per-stream knob present in `j` on top of `sc`. Used for the
+// "defaults" object and then for each stream, so streams inherit defaults.
+void apply_stream_knobs(const json& j, StreamConfig& sc) {
+    StreamSource& src = sc.source;
+    if (j.contains("transport"))       src.transport  = parse_transport(get_or<std::string>(j, "transport", ""));
+    if (j.contains("latency_profile")) src.latency_ms = latency_for_profile(get_or<std::string>(j, "latency_profile", ""));
+    if (j.contains("latency_ms"))      src.latency_ms = get_or<int>(j, "latency_ms", -1);
+    if (j.contains("decode"))          src.decode     = parse_decode(get_or<std::string>(j, "decode", ""));
+    if (j.contains("pacing"))          src.pacing     = parse_pacing(get_or<std::string>(j, "pacing", ""));
+    src.loop     = get_or<bool>(j, "loop", src.loop);
+    src.dmabuf   = get_or<bool>(j, "dmabuf", src.dmabuf);
+    src.gl_upload = get_or<bool>(j, "gl_upload", src.gl_upload);
+    src.rtp_caps = get_or<std::string>(j, "rtp_caps", src.rtp_caps);
+
+    auto inf = j.find("inference");
+    if (inf == j.end()) return;
+    if (inf->is_boolean()) {
+        if (!inf->get<bool>()) sc.schedule.target_hz = 0.0;
+        return;
+    }
+    if (!inf->is_object()) throw ConfigError("inference must be an object or false");
+    sc.schedule.target_hz   = get_or<double>(*inf, "hz", sc.schedule.target_hz);
+    sc.schedule.deadline_ms = get_or<double>(*inf, "deadline_ms", sc.schedule.deadline_ms);
+    sc.schedule.priority    = get_or<int>(*inf, "priority", sc.schedule.priority);
+    if (sc.schedule.deadline_ms <= 0.0) throw ConfigError("inference.deadline_ms must be > 0");
+}
+
+AppConfig parse(const json& root) {
+    if (!root.is_object()) throw ConfigError("top level must be an object");
+    AppConfig cfg;
+
+    StreamConfig defaults;
+    if (auto d = root.find("defaults"); d != root.end()) {
+        if (!d->is_object()) throw ConfigError("defaults must be an object");
+        apply_stream_knobs(*d, defaults);
+    }
+
+    const std::string root_url = get_or<std::string>(root, "root_url", "");
+    auto streams = root.find("streams");
+    if (streams == root.end() || !streams->is_array() || streams->empty())
+        throw ConfigError("streams must be a non-empty array");
+
+    for (size_t i = 0; i < streams->size(); ++i) {
+        const json& js = (*streams)[i];
+        try {
+            if (!js.is_object()) throw ConfigError("must be an object");
+            std::string url = get_or<std::string>(js, "url", "");
+            if (url.empty() && js.contains("endpoint")) {
+                if (root_url.empty()) throw ConfigError("endpoint needs a top-level root_url");
+                url = root_url + get_or<std::string>(js, "endpoint", "");
+            }
+            if (url.empty()) throw ConfigError("needs url or endpoint");
+
+            StreamConfig sc = defaults;
+            const StreamSource parsed = StreamSource::from_url(url);
+            sc.source.kind     = parsed.kind;
+            sc.source.location = parsed.location;
+            apply_stream_knobs(js, sc);
+            cfg.streams.push_back(std::move(sc));
+        } catch (const ConfigError& e) {
+            throw ConfigError("streams[" + std::to_string(i) + "]: " + e.what());
+        }
+    }
+
+    if (auto l = root.find("layout"); l != root.end()) {
+        cfg.layout.title   = get_or<std::string>(*l, "title", cfg.layout.title);
+        cfg.layout.columns = get_or<int>(*l, "columns", cfg.layout.columns);
+        cfg.layout.slots   = get_or<int>(*l, "slots", cfg.layout.slots);
+        cfg.layout.present_latency_ms = get_or<int>(*l, "present_latency_ms", cfg.layout.present_latency_ms);
+        cfg.layout.upload_budget_ms   = get_or<double>(*l, "upload_budget_ms", cfg.layout.upload_budget_ms);
+        cfg.layout.upload_budget_mb   = get_or<double>(*l, "upload_budget_mb", cfg.layout.upload_budget_mb);
+        if (auto w = l->find("window"); w != l->end()) {
+            if (!w->is_array() || w->size() != 2) throw ConfigError("layout.window must be [width, height]");
+            cfg.layout.window_width  = (*w)[0].get<int>();
+            cfg.layout.window_height = (*w)[1].get<int>();
+        }
+        if (cfg.layout.columns < 0 || cfg.layout.slots < 0 || cfg.layout.present_latency_ms < 0 ||
+            cfg.layout.upload_budget_ms < 0 || cfg.layout.upload_budget_mb < 0 ||
+            cfg.layout.window_width <= 0 || cfg.layout.window_height <= 0)
+            throw ConfigError("layout values must be positive");
+        if (cfg.layout.present_latency_ms > VideoRenderer::kMaxPresentLatencyMs)
+            throw ConfigError("layout.present_latency_ms must be at most " +
+                              std::to_string(VideoRenderer::kMaxPresentLatencyMs));
+        if (auto ws = l->find("windows"); ws != l->end()) {
+            if (!ws->is_array() || ws->empty()) throw ConfigError("layout.windows must be a non-empty array");
+            for (const json& jw : *ws) {
+                WindowSpec w;
+                w.title   = get_or<std::string>(jw, "title", cfg.layout.title);
+                w.columns = get_or<int>(jw, "columns", cfg.layout.columns);
+                w.width   = cfg.layout.window_width;
+                w.height  = cfg.layout.window_height;
+                if (auto size = jw.find("window"); size != jw.end()) {
+                    if (!size->is_array() || size->size() != 2)
+                        throw ConfigError("layout.windows[].window must be [width, height]");
+                    w.width  = (*size)[0].get<int>();
+                    w.height = (*size)[1].get<int>();
+                }
+                w.monitor = get_or<int>(jw, "monitor", -1);
+                w.slots   = get_or<std::vector<int>>(jw, "slots", {});
+                if (w.columns < 0 || w.width <= 0 || w.height <= 0)
+                    throw ConfigError("layout.windows values must be positive");
+                cfg.layout.windows.push_back(std::move(w));
+            }
+        }
+    }
+
+    if (auto m = root.find("model"); m != root.end()) {
+        cfg.model.path           = get_or<std::string>(*m, "path", "");
+        cfg.model.backend        = get_or<std::string>(*m, "backend", cfg.model.backend);
+        cfg.model.min_score      = get_or<float>(*m, "min_score", cfg.model.min_score);
+        cfg.model.max_detections = get_or<int>(*m, "max_detections", cfg.model.max_detections);
+        if (m->contains("dynamic_input"))
+            cfg.model.input.dynamic = get_or<bool>(*m, "dynamic_input", false) ? 1 : 0;
+        cfg.model.input.cache_size = get_or<int>(*m, "input_cache", cfg.model.input.cache_size);
+        cfg.model.input.prewarm    = get_or<std::vector<std::pair<int, int>>>(*m, "prewarm", {});
+        if (cfg.model.input.cache_size < 1) throw ConfigError("model.input_cache must be >= 1");
+        if (cfg.model.path.empty()) throw ConfigError("model.path is required");
+    }
+
+    if (auto x = root.find("export"); x != root.end()) {
+        if (auto d = x->find("detections"); d != x->end() && !d->is_null() && *d != false) {
+            cfg.exports.detections         = true;
+            cfg.exports.detection_capacity = get_or<uint32_t>(*d, "capacity", cfg.exports.detection_capacity);
+        }
+        if (auto f = x->find("frames"); f != x->end() && !f->is_null() && *f != false) {
+            cfg.exports.frames           = true;
+            cfg.exports.frame_slots      = get_or<int>(*f, "slots", cfg.exports.frame_slots);
+            cfg.exports.frame_max_width  = get_or<int>(*f, "max_width", cfg.exports.frame_max_width);
+            cfg.exports.frame_max_height = get_or<int>(*f, "max_height", cfg.exports.frame_max_height);
+        }
+    }
+
+    if (auto c = root.find("control"); c != root.end()) {
+        if (!c->is_object()) throw ConfigError("control must be an object");
+        cfg.control.socket = get_or<std::string>(*c, "socket", "");
+        if (cfg.control.socket.empty()) throw ConfigError("control.socket is required");
+    }
+    if (auto q = root.find("quality"); q != root.end()) {
+        if (!q->is_object()) throw ConfigError("quality must be an object");
+        QualityTargets& t = cfg.quality.targets;
+        cfg.quality.enabled    = true;
+        t.render_period_ms     = get_or<double>(*q, "render_period_ms", t.render_period_ms);
+        t.decode_lag_ms        = get_or<double>(*q, "decode_lag_ms", t.decode_lag_ms);
+        t.inference_miss_ratio = get_or<double>(*q, "inference_miss_ratio", t.inference_miss_ratio);
+        if (t.render_period_ms <= 0 || t.decode_lag_ms <= 0 || t.inference_miss_ratio <= 0)
+            throw ConfigError("quality thresholds must be positive");
+    }
+    cfg.headless         = get_or<bool>(root, "headless", false);
+    cfg.consumer_threads = get_or<int>(root, "consumer_threads", 0);
+    if (cfg.consumer_threads < 0) throw ConfigError("consumer_threads must be >= 0");
+    return cfg;
+}
+
+} // namespace
+
+bool load_app_config(const std::string& path, AppConfig& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "[AppConfig] Cannot open " << path << "\n";
+        return false;
+    }
+    try {
+        // Comments allowed: deployment files are hand-edited.
+        const json root = json::parse(in, nullptr, true, true);
+        out = parse(root);
+    } catch (const json::exception& e) {
+        std::cerr << "[AppConfig] " << path << ": " << e.what() << "\n";
+        return false;
+    } catch (const ConfigError& e) {
+        std::cerr << "[AppConfig] " << path << ": " << e.what() << "\n";
+        return false;
+    }
+    std::cout << "[AppConfig] Loaded " << out.streams.size() << " stream(s) from " << path << "\n";
+    return true;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "inference_engine.h"
+#include "inference_scheduler.h"
+#include "quality_controller.h"
+#include "rtsp_stream_manager.h"
+#include "video_renderer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Declarative deployment description, loaded from JSON by load_app_config().
+//
+//   {
+//     "root_url": "rtsp://10.0.0.5:554",              // optional prefix for "endpoint"
+//     "defaults": { "transport": "tcp", "latency_profile": "low",
+//                   "decode": "auto", "inference": { "hz": 5 } },
+//     "streams": [
+//       { "endpoint": "/ch0", "inference": { "hz": 10, "priority": 2 } },
+//       { "url": "rtsp://cam2/live", "transport": "udp", "latency_ms": 120 },
+//       { "url": "clip.mp4", "pacing": "fast", "loop": true, "inference": false }
+//     ],
+//     "layout":  { "title": "Lobby", "columns": 4, "window": [1920, 1080], "slots": 8,
+//                  "present_latency_ms": 40, "upload_budget_ms": 8, "upload_budget_mb": 0,
+//                  "windows": [ { "monitor": 0, "slots": [0, 1, 2, 3] },
+//                               { "monitor": 1, "slots": [4, 5, 6, 7], "columns": 2 } ] },
+//     "model":   { "path": "ssd.tflite", "backend": "cpu-mt", "min_score": 0.5,
+//                  "dynamic_input": true, "input_cache": 4, "prewarm": [[1920, 1080]] },
+//     "export":  { "detections": { "capacity": 1024 },
+//                  "frames": { "slots": 8, "max_width": 1920, "max_height": 1080 } },
+//     "control": { "socket": "/tmp/rtspreceiver.sock" },
+//     "headless": false,                               // true: no window, layout ignored
+//     "consumer_threads": 4,                           // shared appsink pull pool
+//     "quality": { "render_period_ms": 25, "decode_lag_ms": 250,
+//                  "inference_miss_ratio": 0.2 }       // overload degradation
+//   }
+//
+// Every stream key except url/endpoint may also appear under "defaults".
+// latency_profile: "low" (100 ms), "balanced" (500 ms), "robust" (2000 ms);
+// an explicit latency_ms wins. "dmabuf": true lets display-only streams
+// hand DMABuf decoder output straight to the renderer; "gl_upload": true
+// has them upload and convert in GStreamer GL, sharing textures with the
+// renderer (see gl_ingest.h). layout.slots reserves grid cells for streams
+// added later through the control API (see control_server.h).
+// layout.windows opens one window per entry ("title", "columns", "window",
+// "monitor" for fullscreen, "slots" shown; missing keys inherit from layout),
+// all drawn by the one render loop from textures uploaded once.
+// layout.present_latency_ms > 0 paces each cell by PTS at that extra delay
+// (see VideoRenderer::set_present_latency_ms). upload_budget_ms/_mb cap the
+// texture uploads of one frame (0: uncapped).
+
+struct StreamConfig {
+    StreamSource   source;
+    StreamSchedule schedule;  // target_hz ≤ 0: no inference on this stream
+};
+
+struct LayoutConfig {
+    std::string title         = "RTSP Stream";
+    int         columns       = 0;  // 0: near-square grid
+    int         window_width  = 1280;
+    int         window_height = 720;
+    int         slots         = 0;  // grid cells; 0 or fewer than streams: one per stream
+    int         present_latency_ms = 0;  // 0: newest frame at every redraw
+    double      upload_budget_ms   = 8.0;
+    double      upload_budget_mb   = 0.0;
+    std::vector<WindowSpec> windows;     // empty: one window with every slot
+};
+
+struct ModelConfig {
+    std::string path;              // empty: inference disabled
+    std::string backend   = "auto";
+    float       min_score = 0.5f;
+    int         max_detections = 32;
+    EngineInputOptions input;      // dynamic_input absent: from the model
+};
+
+struct ExportConfig {
+    bool     detections          = false;
+    uint32_t detection_capacity  = 1024;
+    bool     frames              = false;
+    int      frame_slots         = 8;
+    int      frame_max_width     = 1920;
+    int      frame_max_height    = 1080;
+};
+
+struct ControlConfig {
+    std::string socket;  // empty: control API disabled
+};
+
+struct QualityConfig {
+    bool           enabled = false;  // "quality" present
+    QualityTargets targets;
+};
+
+struct AppConfig {
+    std::vector<StreamConfig> streams;
+    LayoutConfig              layout;
+    ModelConfig               model;
+    ExportConfig              exports;
+    ControlConfig             control;
+    QualityConfig             quality;
+    bool                      headless = false;
+    int                       consumer_threads = 0;  // > 0: SampleDelivery::Pool
+};
+
+// Parse and validate a config file. On error logs the offending key and
+// returns false; `out` is only modified on success.
+bool load_app_config(const std::string& path, AppConfig& out);
@@ -0,0 +1,100 @@
+#include "backend_registry.h"
+#include "cpu_backend.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+// ---------------------------------------------------------------------------
+// Built-in CPU variants
+// ---------------------------------------------------------------------------
+
+static int hardware_threads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
+
+static void register_builtin(BackendRegistry& r) {
+    constexpr uint32_t kCpuCaps = kBackendBatch | kBackendDynamicInput | kBackendQuantized;
+
+    r.add({"cpu", "LiteRT CPU, XNNPACK, 1 thread", kCpuCaps, 100, [] {
+        return std::unique_ptr<InferenceBackend>(new CpuBackend());
+    }});
+    r.add({"cpu-mt", "LiteRT CPU, XNNPACK, one thread per core",
+           kCpuCaps | kBackendMultiThread, 90, [] {
+        auto b = std::make_unique<CpuBackend>();
+        b->set_num_threads(hardware_threads());
+        return std::unique_ptr<InferenceBackend>(std::move(b));
+    }});
+    r.add({"cpu-fp16", "LiteRT CPU, XNNPACK forced fp16", kCpuCaps | kBackendFp16, 50, [] {
+        auto b = std::make_unique<CpuBackend>();
+        b->set_precision(CpuPrecision::Fp16);
+        return std::unique_ptr<InferenceBackend>(std::move(b));
+    }});
+    // Lowest priority: the last resort when XNNPACK cannot handle a model.
+    r.add({"cpu-reference", "LiteRT builtin kernels, no XNNPACK", kCpuCaps, 10, [] {
+        auto b = std::make_unique<CpuBackend>();
+        b->set_use_xnnpack(false);
+        return std::unique_ptr<InferenceBackend>(std::move(b));
+    }});
+}
+
+// ---------------------------------------------------------------------------
+// BackendRegistry
+// ---------------------------------------------------------------------------
+
+BackendRegistry& BackendRegistry::instance() {
+    static BackendRegistry registry;
+    return registry;
+}
+
+BackendRegistry::BackendRegistry() { register_builtin(*this); }
+
+bool BackendRegistry::add(BackendInfo info) {
+    if (info.name.empty() || !info.factory) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& b : backends_) {
+        if (b.name == info.name) {
+            std::cerr << "[BackendRegistry] Duplicate backend: " << info.name << "\n";
+            return false;
+        }
+    }
+    auto pos = std::find_if(backends_.begin(), backends_.end(),
+                            [&](const BackendInfo& b) { return b.priority < info.priority; });
+    backends_.insert(pos, std::move(info));
+    return true;
+}
+
+bool BackendRegistry::contains(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::any_of(backends_.begin(), backends_.end(),
+                       [&](const BackendInfo& b) { return b.name == name; });
+}
+
+std::vector<BackendInfo> BackendRegistry::candidates(const std::string& preferred,
+                                                     uint32_t required_caps) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<BackendInfo> out;
+    const bool any = preferred.empty() || preferred == "auto";
+
+    if (!any) {
+        auto it = std::find_if(backends_.begin(), backends_.end(),
+                               [&](const BackendInfo& b) { return b.name == preferred; });
+        if (it == backends_.end())
+            std::cerr << "[BackendRegistry] Unknown backend '" << preferred << "', using fallbacks\n";
+        else if ((it->caps & required_caps) != required_caps)
+            std::cerr << "[BackendRegistry] Backend '" << preferred << "' lacks required capabilities\n";
+        else
+            out.push_back(*it);
+    }
+    for (const auto& b : backends_) {
+        if (!any && b.name == preferred) continue;
+        if ((b.caps & required_caps) == required_caps) out.push_back(b);
+    }
+    return out;
+}
+
+std::vector<BackendInfo> BackendRegistry::list() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return backends_;
+}
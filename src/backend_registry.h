@@ -0,0 +1,57 @@
+#pragma once
+
+#include "inference_backend.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Capability flags a backend advertises; callers may require a subset.
+enum BackendCaps : uint32_t {
+    kBackendBatch        = 1u << 0,  // process_batch() can resize the batch dimension
+    kBackendDynamicInput = 1u << 1,  // per-shape interpreters for dynamic H/W models
+    kBackendFp16         = 1u << 2,  // half-precision arithmetic
+    kBackendQuantized    = 1u << 3,  // int8 / uint8 model tensors
+    kBackendMultiThread  = 1u << 4,  // uses more than one CPU thread per inference
+};
+
+struct BackendInfo {
+    std::string name;         // e.g. "cpu", "cpu-reference"
+    std::string description;
+    uint32_t    caps     = 0;  // BackendCaps bitmask
+    int         priority = 0;  // higher is tried first by "auto"
+    std::function<std::unique_ptr<InferenceBackend>()> factory;
+};
+
+// Process-wide table of named InferenceBackend factories.
+//
+// InferenceEngine asks for a backend by name ("auto" = highest priority) and
+// walks the candidate list until one prepares successfully, so a missing GPU
+// or NPU delegate degrades to the CPU path instead of failing outright.
+// The built-in CPU variants are registered on first use; platform backends
+// add themselves with add() before the first engine is created.
+class BackendRegistry {
+public:
+    static BackendRegistry& instance();
+
+    // Returns false (and leaves the table unchanged) if the name is taken.
+    bool add(BackendInfo info);
+
+    bool contains(const std::string& name) const;
+
+    // Backends to try in order: `preferred` first (unless "auto" or empty),
+    // then every other backend having `required_caps`, by descending priority.
+    std::vector<BackendInfo> candidates(const std::string& preferred,
+                                        uint32_t required_caps = 0) const;
+
+    std::vector<BackendInfo> list() const;
+
+private:
+    BackendRegistry();
+
+    mutable std::mutex       mutex_;
+    std::vector<BackendInfo> backends_;  // kept sorted by descending priority
+};
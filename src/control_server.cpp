@@ -0,0 +1,251 @@
+#include "control_server.h"
+#include "inference_engine.h"
+#include "inference_scheduler.h"
+#include "result_timeline.h"
+#include "rtsp_stream_manager.h"
+#include "video_renderer.h"
+
+#include <nlohmann/json.hpp>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using json = nlohmann::json;
+
+static constexpr auto kReplyTimeout = std::chrono::seconds(2);
+
+ControlServer::ControlServer(const ControlTargets& targets) : targets_(targets) {}
+
+ControlServer::~ControlServer() { stop(); }
+
+// ---------------------------------------------------------------------------
+// Socket thread
+// ---------------------------------------------------------------------------
+
+bool ControlServer::start(const std::string& socket_path) {
+    if (running_) return true;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[ControlServer] Socket path too long: " << socket_path << "\n";
+        return false;
+    }
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "[ControlServer] socket failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    unlink(socket_path.c_str());  // stale socket from a previous run
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 4) != 0) {
+        std::cerr << "[ControlServer] Cannot listen on " << socket_path << ": " << std::strerror(errno) << "\n";
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    socket_path_ = socket_path;
+    running_     = true;
+    thread_      = std::thread(&ControlServer::serve, this);
+    std::cout << "[ControlServer] Listening on " << socket_path_ << "\n";
+    return true;
+}
+
+void ControlServer::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(socket_path_.c_str());
+}
+
+void ControlServer::serve() {
+    while (running_) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue;  // timeout: re-check running_
+        const int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;
+        serve_client(client);  // one client at a time: control traffic is tiny
+        close(client);
+    }
+}
+
+void ControlServer::serve_client(int fd) {
+    std::string buffer;
+    char chunk[1024];
+    while (running_) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        const ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) return;  // client closed
+        buffer.append(chunk, static_cast<size_t>(n));
+        if (buffer.size() > 64 * 1024) return;  // no line that long is valid
+
+        size_t eol;
+        while ((eol = buffer.find('\n')) != std::string::npos) {
+            Request req;
+            req.line = buffer.substr(0, eol);
+            buffer.erase(0, eol + 1);
+            if (req.line.empty()) continue;
+
+            auto state = std::make_shared<std::atomic<RequestState>>(RequestState::Queued);
+            req.state  = state;
+            std::future<std::string> reply = req.reply.get_future();
+            std::string  out;
+            RequestState queued = RequestState::Queued;
+            if (!queue_.push(std::move(req)))
+                out = R"({"ok":false,"error":"busy"})";
+            else if (reply.wait_for(kReplyTimeout) != std::future_status::ready &&
+                     state->compare_exchange_strong(queued, RequestState::Cancelled))
+                out = R"({"ok":false,"error":"timed out waiting for the render loop"})";
+            else
+                out = reply.get();  // done, or running right now: wait for it
+            out += '\n';
+            if (write(fd, out.data(), out.size()) < 0) return;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Owner thread
+// ---------------------------------------------------------------------------
+
+void ControlServer::apply_pending() {
+    Request req;
+    while (queue_.pop(req)) {
+        RequestState queued = RequestState::Queued;
+        if (!req.state->compare_exchange_strong(queued, RequestState::Running)) continue;  // client gave up
+        req.reply.set_value(execute(req.line));
+    }
+}
+
+static json error(const std::string& message) {
+    return {{"ok", false}, {"error", message}};
+}
+
+std::string ControlServer::execute(const std::string& line) {
+    json reply;
+    try {
+        const json req = json::parse(line);
+        const std::string cmd = req.at("cmd").get<std::string>();
+        RtspStreamManager*  manager   = targets_.manager;
+        InferenceScheduler* scheduler = targets_.scheduler;
+
+        if (cmd == "list") {
+            if (!manager) return error("no stream manager").dump();
+            json streams = json::array();
+            for (const auto& s : manager->streams()) {
+                json js = {{"slot", s->get_slot()},
+                           {"url", s->get_url()},
+                           {"playing", s->is_playing()},
+                           {"frames", s->frames_received()},
+                           {"rate_limited", s->frames_rate_limited()},
+                           {"max_fps", s->max_fps()},
+                           {"decode_lag_ms", s->decode_lag_ms()},
+                           {"downscale", s->downscale()},
+                           {"keyframes_only", s->keyframes_only()}};
+                if (scheduler) js["inference_hz"] = scheduler->schedule(s->get_slot()).target_hz;
+                streams.push_back(std::move(js));
+            }
+            reply = {{"ok", true}, {"streams", std::move(streams)}};
+        } else if (cmd == "stats") {
+            if (!scheduler) return error("inference is not enabled").dump();
+            json out = json::array();
+            for (const auto& s : scheduler->stats())
+                out.push_back({{"slot", s.slot},
+                               {"achieved_hz", s.achieved_hz},
+                               {"latency_ms", s.latency_ms},
+                               {"frames_seen", s.frames_seen},
+                               {"inferences", s.inferences},
+                               {"skipped_stale", s.skipped_stale},
+                               {"deadline_misses", s.deadline_misses}});
+            reply = {{"ok", true}, {"streams", std::move(out)}};
+        } else if (cmd == "set_stream_fps") {
+            RtspStream* s = manager ? manager->find_stream(req.at("slot").get<int>()) : nullptr;
+            if (!s) return error("no such stream").dump();
+            s->set_max_fps(req.at("fps").get<double>());
+            reply = {{"ok", true}};
+        } else if (cmd == "set_inference_hz") {
+            if (!scheduler) return error("inference is not enabled").dump();
+            const int slot = req.at("slot").get<int>();
+            StreamSchedule sched = scheduler->schedule(slot);
+            sched.target_hz   = req.at("hz").get<double>();
+            sched.priority    = req.value("priority", sched.priority);
+            sched.deadline_ms = req.value("deadline_ms", sched.deadline_ms);
+            scheduler->configure_stream(slot, sched);
+            reply = {{"ok", true}};
+        } else if (cmd == "set_layout") {
+            if (!targets_.renderer) return error("no renderer").dump();
+            const int columns = req.at("columns").get<int>();
+            const int window  = req.value("window", 0);
+            if (columns < 1) return error("columns must be >= 1").dump();
+            if (window < 0 || window >= targets_.renderer->window_count()) return error("no such window").dump();
+            targets_.renderer->set_columns(columns, window);
+            reply = {{"ok", true}};
+        } else if (cmd == "focus") {
+            if (!targets_.renderer) return error("no renderer").dump();
+            const int slot = req.at("slot").get<int>();
+            if (slot >= targets_.renderer->slot_count()) return error("no such slot").dump();
+            targets_.renderer->set_focus(slot);
+            reply = {{"ok", true}};
+        } else if (cmd == "add_stream") {
+            if (!manager) return error("no stream manager").dump();
+            StreamSource src = StreamSource::from_url(req.at("url").get<std::string>());
+            const int slot = manager->add_stream(src);
+            if (slot < 0) return error("no free slot").dump();
+            if (scheduler) {
+                StreamSchedule sched;
+                sched.target_hz = req.value("hz", sched.target_hz);
+                scheduler->configure_stream(slot, sched);
+            }
+            reply = {{"ok", true}, {"slot", slot}};
+        } else if (cmd == "remove_stream") {
+            const int slot = req.at("slot").get<int>();
+            if (!manager || !manager->remove_stream(slot)) return error("no such stream").dump();
+            if (targets_.renderer) targets_.renderer->clear_slot(slot);
+            if (scheduler) scheduler->remove_stream(slot);
+            if (targets_.timeline) targets_.timeline->clear(slot);
+            reply = {{"ok", true}};
+        } else if (cmd == "results") {
+            // The result that was current for a frame: inference runs behind
+            // the video, so a client tagging frame PTS gets matching boxes.
+            if (!targets_.timeline) return error("inference is not enabled").dump();
+            const int   slot = req.at("slot").get<int>();
+            TimedResult r;
+            const bool  found = req.contains("pts_ns")
+                ? targets_.timeline->lookup(slot, req.at("pts_ns").get<int64_t>(), r)
+                : targets_.timeline->latest(slot, r);
+            if (!found) return error("no result").dump();
+            json dets = json::array();
+            for (const Detection& d : r.detections)
+                dets.push_back({{"box", {d.x0, d.y0, d.x1, d.y1}}, {"score", d.score}, {"class", d.class_id}});
+            reply = {{"ok", true},
+                     {"pts_ns", r.frame.pts_ns},
+                     {"frame_index", r.frame.frame_index},
+                     {"detections", std::move(dets)}};
+        } else if (cmd == "reload_model") {
+            if (!targets_.engine) return error("inference is not enabled").dump();
+            if (!targets_.engine->reload(req.at("path").get<std::string>()))
+                return error("a reload is already in progress").dump();
+            reply = {{"ok", true}};
+        } else {
+            return error("unknown cmd: " + cmd).dump();
+        }
+    } catch (const json::exception& e) {
+        return error(e.what()).dump();
+    } catch (const std::exception& e) {
+        // A failing target must not take the owner's loop down with it.
+        return error(e.what()).dump();
+    }
+    return reply.dump();
+}
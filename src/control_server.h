@@ -0,0 +1,83 @@
+#pragma once
+
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+class InferenceEngine;
+class InferenceScheduler;
+class ResultTimeline;
+class RtspStreamManager;
+class VideoRenderer;
+
+// Objects the control API may act on; any may be null (commands touching a
+// missing target answer with an error). Not owned.
+struct ControlTargets {
+    RtspStreamManager*  manager   = nullptr;
+    VideoRenderer*      renderer  = nullptr;
+    InferenceScheduler* scheduler = nullptr;
+    InferenceEngine*    engine    = nullptr;
+    ResultTimeline*     timeline  = nullptr;
+};
+
+// Local runtime-tuning API: newline-delimited JSON over a Unix socket.
+//
+//   {"cmd": "list"}
+//   {"cmd": "stats"}
+//   {"cmd": "set_stream_fps",   "slot": 2, "fps": 10}      // 0 = uncapped
+//   {"cmd": "set_inference_hz", "slot": 2, "hz": 1, "priority": 0}
+//   {"cmd": "set_layout",       "columns": 3, "window": 0}  // window optional
+//   {"cmd": "focus",            "slot": 2}              // -1 = none; uploads first
+//   {"cmd": "add_stream",       "url": "rtsp://cam/live", "hz": 5}
+//   {"cmd": "remove_stream",    "slot": 2}
+//   {"cmd": "reload_model",     "path": "new.tflite"}
+//   {"cmd": "results",          "slot": 2, "pts_ns": 123}  // pts_ns optional: newest
+//
+// Each request gets one JSON line back: {"ok": true, ...} or
+// {"ok": false, "error": "..."}.
+//
+// The socket is served from a dedicated thread that never touches the
+// targets: requests travel through a lock-free queue and are executed by
+// apply_pending(), which the thread owning the targets (the main loop)
+// calls every iteration. Renderer changes are forwarded to the render thread
+// and land at frame boundaries, with no locks added to the streaming or
+// render paths.
+class ControlServer {
+public:
+    explicit ControlServer(const ControlTargets& targets);
+    ~ControlServer();
+
+    // Binds socket_path (replacing a stale socket file) and starts serving.
+    bool start(const std::string& socket_path);
+    void stop();
+
+    // Owner thread, every loop iteration: execute queued requests.
+    void apply_pending();
+
+private:
+    // Claimed by exactly one side: the owner thread to run it, or the
+    // socket thread to cancel it after kReplyTimeout, so a request answered
+    // as timed out never runs later.
+    enum class RequestState { Queued, Running, Cancelled };
+
+    struct Request {
+        std::string                                line;
+        std::promise<std::string>                  reply;
+        std::shared_ptr<std::atomic<RequestState>> state;
+    };
+
+    void        serve();
+    void        serve_client(int fd);
+    std::string execute(const std::string& line);
+
+    ControlTargets            targets_;
+    std::string               socket_path_;
+    int                       listen_fd_ = -1;
+    std::atomic<bool>         running_{false};
+    std::thread               thread_;
+    SpscQueue<Request, 64>    queue_;
+};
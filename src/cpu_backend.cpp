@@ -2,13 +2,36 @@
 
 // LiteRT headers — available via the transitive include path from tensorflow-lite target.
 // Header paths follow the upstream tensorflow/lite/ layout.
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/kernels/register.h"
 #include "tensorflow/lite/model_builder.h"
 
+#include "tensor_convert.h"
+
 #include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <iterator>
+#include <vector>
+
+// One prepared interpreter at a fixed input shape.
+struct CpuBackend::Instance {
+    // Declared first so it is destroyed last: the interpreter references it.
+    std::unique_ptr<TfLiteDelegate, void (*)(TfLiteDelegate*)> delegate{nullptr, nullptr};
+    std::unique_ptr<tflite::Interpreter> interpreter;
+
+    int  height          = 0;
+    int  width           = 0;
+    bool batch_resizable = true;  // cleared once a batch resize fails
+
+    // Dequantized copies of non-float32 outputs, rebuilt lazily after Invoke.
+    struct OutputCache {
+        std::vector<float> data;
+        bool               valid = false;
+    };
+    std::vector<OutputCache> output_cache;
+};
 
 CpuBackend::CpuBackend()  = default;
 CpuBackend::~CpuBackend() { teardown(); }
@@ -18,6 +41,68 @@ bool CpuBackend::set_model(const std::string& model_path) {
     return true;
 }
 
+// Build an interpreter for model_, resized to height × width first when both
+// are non-zero. The resize happens before any delegate is applied so XNNPACK
+// plans for the final shape.
+std::unique_ptr<CpuBackend::Instance> CpuBackend::build_instance(int height, int width) const {
+    auto inst = std::make_unique<Instance>();
+
+    // Fp16 applies XNNPACK explicitly so its flags can be set; the default
+    // resolver would otherwise apply a second, fp32 XNNPACK instance.
+    // Without XNNPACK only the builtin reference/optimized kernels run.
+    if (precision_ == CpuPrecision::Fp16 || !use_xnnpack_) {
+        tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates resolver;
+        tflite::InterpreterBuilder builder(*model_, resolver);
+        builder(&inst->interpreter);
+    } else {
+        tflite::ops::builtin::BuiltinOpResolver resolver;
+        tflite::InterpreterBuilder builder(*model_, resolver);
+        builder(&inst->interpreter);
+    }
+    if (!inst->interpreter) {
+        std::cerr << "[CpuBackend] Failed to build interpreter\n";
+        return nullptr;
+    }
+
+    tflite::Interpreter& interp = *inst->interpreter;
+    interp.SetNumThreads(num_threads_);
+
+    if (height > 0 && width > 0) {
+        const TfLiteTensor* in = interp.input_tensor(0);
+        if (!in || !in->dims || in->dims->size != 4) return nullptr;
+        const std::vector<int> shape = {in->dims->data[0], height, width, in->dims->data[3]};
+        if (interp.ResizeInputTensor(interp.inputs()[0], shape) != kTfLiteOk) {
+            std::cerr << "[CpuBackend] Cannot resize input to " << width << "x" << height << "\n";
+            return nullptr;
+        }
+    }
+
+    if (precision_ == CpuPrecision::Fp16 && use_xnnpack_) {
+        TfLiteXNNPackDelegateOptions opts = TfLiteXNNPackDelegateOptionsDefault();
+        opts.num_threads = num_threads_;
+        opts.flags      |= TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16;
+        inst->delegate = decltype(inst->delegate)(TfLiteXNNPackDelegateCreate(&opts),
+                                                  TfLiteXNNPackDelegateDelete);
+        if (!inst->delegate || interp.ModifyGraphWithDelegate(inst->delegate.get()) != kTfLiteOk) {
+            std::cerr << "[CpuBackend] XNNPACK fp16 delegate unavailable\n";
+            return nullptr;
+        }
+    }
+
+    if (interp.AllocateTensors() != kTfLiteOk) {
+        std::cerr << "[CpuBackend] AllocateTensors failed\n";
+        return nullptr;
+    }
+
+    const TfLiteTensor* in = interp.input_tensor(0);
+    if (in && in->dims && in->dims->size == 4) {
+        inst->height = in->dims->data[1];
+        inst->width  = in->dims->data[2];
+    }
+    inst->output_cache.assign(interp.outputs().size(), Instance::OutputCache{});
+    return inst;
+}
+
 bool CpuBackend::prepare() {
     model_ = tflite::FlatBufferModel::BuildFromFile(model_path_.c_str());
     if (!model_) {
@@ -25,61 +110,238 @@ bool CpuBackend::prepare() {
         return false;
     }
 
-    tflite::ops::builtin::BuiltinOpResolver resolver;
-    tflite::InterpreterBuilder builder(*model_, resolver);
-    builder(&interpreter_);
-    if (!interpreter_) {
-        std::cerr << "[CpuBackend] Failed to build interpreter\n";
+    auto inst = build_instance(0, 0);
+    if (!inst) {
+        model_.reset();
         return false;
     }
 
-    interpreter_->SetNumThreads(num_threads_);
-    if (interpreter_->AllocateTensors() != kTfLiteOk) {
-        std::cerr << "[CpuBackend] AllocateTensors failed\n";
-        return false;
-    }
+    // A -1 in the input signature's H or W marks a fully-convolutional model.
+    const TfLiteTensor* in = inst->interpreter->input_tensor(0);
+    if (!dynamic_explicit_ && in && in->dims_signature && in->dims_signature->size == 4 &&
+        (in->dims_signature->data[1] < 0 || in->dims_signature->data[2] < 0))
+        dynamic_input_ = true;
 
     std::cout << "[CpuBackend] Ready — model: " << model_path_
-              << ", threads: " << num_threads_ << "\n";
+              << ", threads: " << num_threads_
+              << ", input: " << (in ? TfLiteTypeGetName(in->type) : "?")
+              << (precision_ == CpuPrecision::Fp16 && use_xnnpack_ ? ", fp16" : "")
+              << (use_xnnpack_ ? "" : ", no XNNPACK")
+              << (dynamic_input_ ? ", dynamic input" : "") << "\n";
+
+    instances_.push_front(std::move(inst));
+    active_ = instances_.front().get();
     return true;
 }
 
 void CpuBackend::teardown() {
-    interpreter_.reset();
+    active_ = nullptr;
+    instances_.clear();
     model_.reset();
 }
 
-bool CpuBackend::process(const uint8_t* rgb_data, int width, int height) {
-    if (!interpreter_) return false;
+bool CpuBackend::select_instance(int width, int height) {
+    if (!dynamic_input_) return true;
+    if (active_->width == width && active_->height == height) return true;
+
+    for (auto it = instances_.begin(); it != instances_.end(); ++it) {
+        if ((*it)->width == width && (*it)->height == height) {
+            instances_.splice(instances_.begin(), instances_, it);
+            active_ = instances_.front().get();
+            return true;
+        }
+    }
+
+    auto inst = build_instance(height, width);
+    if (!inst) {
+        // The model is not actually shape-agnostic: callers go back to rescaling.
+        std::cerr << "[CpuBackend] Disabling dynamic input\n";
+        dynamic_input_ = false;
+        return false;
+    }
+    instances_.push_front(std::move(inst));
+    while (static_cast<int>(instances_.size()) > cache_size_) instances_.pop_back();
+    active_ = instances_.front().get();
+    std::cout << "[CpuBackend] Prepared interpreter for " << width << "x" << height
+              << " (" << instances_.size() << "/" << cache_size_ << " cached)\n";
+    return true;
+}
+
+bool CpuBackend::prewarm_input_size(int width, int height) {
+    if (!active_ || !dynamic_input_) return false;
+    for (const auto& inst : instances_)
+        if (inst->width == width && inst->height == height) return true;
 
-    // Copy raw RGB bytes into input tensor[0].
-    // The caller is responsible for ensuring the frame dimensions match the
-    // model's expected input shape (resize/crop before calling if needed).
-    TfLiteTensor* in = interpreter_->input_tensor(0);
+    auto inst = build_instance(height, width);
+    if (!inst) {
+        std::cerr << "[CpuBackend] Disabling dynamic input\n";
+        dynamic_input_ = false;
+        return false;
+    }
+    std::cout << "[CpuBackend] Prewarmed interpreter for " << width << "x" << height << "\n";
+    if (cache_size_ == 1) {
+        // Room for one shape: the one expected next wins.
+        instances_.clear();
+        instances_.push_front(std::move(inst));
+        active_ = instances_.front().get();
+        return true;
+    }
+    // Right behind the active shape, so the eviction below cannot take it.
+    instances_.insert(std::next(instances_.begin()), std::move(inst));
+    while (static_cast<int>(instances_.size()) > cache_size_) instances_.pop_back();
+    return true;
+}
+
+bool CpuBackend::fill_input(const uint8_t* rgb_data, size_t bytes) {
+    TfLiteTensor* in = active_->interpreter->input_tensor(0);
     if (!in) return false;
 
-    const int copy_bytes = std::min<int>(static_cast<int>(in->bytes), width * height * 3);
-    std::memcpy(in->data.raw, rgb_data, copy_bytes);
+    const float inv_std = input_std_ != 0.f ? 1.f / input_std_ : 1.f;
+    switch (in->type) {
+        case kTfLiteUInt8:
+            std::memcpy(in->data.raw, rgb_data, std::min<size_t>(in->bytes, bytes));
+            return true;
+        case kTfLiteInt8: {
+            // Fold normalization and quantization into one affine map.
+            const float scale = in->params.scale != 0.f ? in->params.scale : 1.f;
+            const float a     = inv_std / scale;
+            const float b     = static_cast<float>(in->params.zero_point) - input_mean_ * a;
+            affine_u8_to_s8(rgb_data, in->data.int8, std::min<size_t>(in->bytes, bytes), a, b);
+            return true;
+        }
+        case kTfLiteFloat32:
+            affine_u8_to_f32(rgb_data, in->data.f,
+                             std::min<size_t>(in->bytes / sizeof(float), bytes),
+                             input_mean_, inv_std);
+            return true;
+        case kTfLiteFloat16: {
+            uint16_t* dst = reinterpret_cast<uint16_t*>(in->data.raw);
+            const size_t n = std::min<size_t>(in->bytes / sizeof(uint16_t), bytes);
+            float chunk[1024];
+            for (size_t i = 0; i < n; i += 1024) {
+                const size_t c = std::min<size_t>(1024, n - i);
+                affine_u8_to_f32(rgb_data + i, chunk, c, input_mean_, inv_std);
+                float_to_half(chunk, dst + i, c);
+            }
+            return true;
+        }
+        default:
+            std::cerr << "[CpuBackend] Unsupported input type: " << TfLiteTypeGetName(in->type) << "\n";
+            return false;
+    }
+}
 
-    if (interpreter_->Invoke() != kTfLiteOk) {
+bool CpuBackend::invoke() {
+    for (auto& c : active_->output_cache) c.valid = false;
+    if (active_->interpreter->Invoke() != kTfLiteOk) {
         std::cerr << "[CpuBackend] Invoke failed\n";
         return false;
     }
     return true;
 }
 
+bool CpuBackend::process(const uint8_t* rgb_data, int width, int height) {
+    if (!active_) return false;
+
+    // Fill input tensor[0] from raw RGB bytes.
+    // Unless the input is dynamic, the caller is responsible for ensuring the
+    // frame dimensions match the model's expected input shape.
+    if (!select_instance(width, height)) return false;
+    if (!fill_input(rgb_data, static_cast<size_t>(width) * height * 3)) return false;
+    return invoke();
+}
+
+bool CpuBackend::process_batch(const uint8_t* rgb_data, int batch, int width, int height) {
+    if (!active_ || batch < 1) return false;
+    if (!select_instance(width, height) || !active_->batch_resizable) return false;
+
+    tflite::Interpreter& interp = *active_->interpreter;
+    TfLiteTensor* in = interp.input_tensor(0);
+    if (!in || !in->dims || in->dims->size != 4) return false;
+
+    // Re-allocating tensors is expensive; callers should bucket batch sizes
+    // (1, 2, 4, 8, …) so this only happens a handful of times per model.
+    if (in->dims->data[0] != batch) {
+        const std::vector<int> original = {in->dims->data[0], in->dims->data[1],
+                                           in->dims->data[2], in->dims->data[3]};
+        const std::vector<int> resized  = {batch, original[1], original[2], original[3]};
+        const int input_idx = interp.inputs()[0];
+        if (interp.ResizeInputTensor(input_idx, resized) != kTfLiteOk ||
+            interp.AllocateTensors() != kTfLiteOk) {
+            std::cerr << "[CpuBackend] Model does not support batch " << batch
+                      << "; falling back to per-frame inference\n";
+            active_->batch_resizable = false;
+            interp.ResizeInputTensor(input_idx, original);
+            interp.AllocateTensors();
+            return false;
+        }
+        active_->output_cache.assign(interp.outputs().size(), Instance::OutputCache{});
+    }
+
+    if (!fill_input(rgb_data, static_cast<size_t>(batch) * width * height * 3)) return false;
+    return invoke();
+}
+
+bool CpuBackend::input_shape(int& batch, int& height, int& width, int& channels) const {
+    if (!active_) return false;
+    const TfLiteTensor* in = active_->interpreter->input_tensor(0);
+    if (!in || !in->dims || in->dims->size != 4) return false;
+    batch    = in->dims->data[0];
+    height   = in->dims->data[1];
+    width    = in->dims->data[2];
+    channels = in->dims->data[3];
+    return true;
+}
+
 int CpuBackend::output_count() const {
-    if (!interpreter_) return 0;
-    return static_cast<int>(interpreter_->outputs().size());
+    if (!active_) return 0;
+    return static_cast<int>(active_->interpreter->outputs().size());
+}
+
+static size_t element_count(const TfLiteTensor* t) {
+    if (!t->dims) return 0;
+    size_t n = 1;
+    for (int i = 0; i < t->dims->size; ++i) n *= static_cast<size_t>(t->dims->data[i]);
+    return n;
 }
 
 const float* CpuBackend::output_data(int idx) const {
-    if (!interpreter_ || idx >= output_count()) return nullptr;
-    return interpreter_->typed_output_tensor<float>(idx);
+    if (!active_ || idx < 0 || idx >= output_count()) return nullptr;
+    const TfLiteTensor* t = active_->interpreter->output_tensor(idx);
+    if (!t) return nullptr;
+    if (t->type == kTfLiteFloat32) return t->data.f;  // zero-copy
+
+    Instance::OutputCache& cache = active_->output_cache[idx];
+    if (cache.valid) return cache.data.data();
+
+    const size_t n = element_count(t);
+    cache.data.resize(n);
+    const float scale = t->params.scale != 0.f ? t->params.scale : 1.f;
+    const float zp    = static_cast<float>(t->params.zero_point);
+    switch (t->type) {
+        case kTfLiteUInt8:
+            affine_u8_to_f32(t->data.uint8, cache.data.data(), n, zp, scale);
+            break;
+        case kTfLiteInt8:
+            affine_s8_to_f32(t->data.int8, cache.data.data(), n, zp, scale);
+            break;
+        case kTfLiteFloat16:
+            half_to_float(reinterpret_cast<const uint16_t*>(t->data.raw), cache.data.data(), n);
+            break;
+        case kTfLiteInt32:
+            std::transform(t->data.i32, t->data.i32 + n, cache.data.begin(),
+                           [](int32_t v) { return static_cast<float>(v); });
+            break;
+        default:
+            std::cerr << "[CpuBackend] Unsupported output type: " << TfLiteTypeGetName(t->type) << "\n";
+            return nullptr;
+    }
+    cache.valid = true;
+    return cache.data.data();
 }
 
 int CpuBackend::output_size(int idx) const {
-    if (!interpreter_ || idx >= output_count()) return 0;
-    const TfLiteTensor* t = interpreter_->output_tensor(idx);
-    return t ? static_cast<int>(t->bytes / sizeof(float)) : 0;
+    if (!active_ || idx < 0 || idx >= output_count()) return 0;
+    const TfLiteTensor* t = active_->interpreter->output_tensor(idx);
+    return t ? static_cast<int>(element_count(t)) : 0;
 }
@@ -1,19 +1,39 @@
 #pragma once
 
 #include "inference_backend.h"
+#include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Forward-declare TFLite types to keep LiteRT headers out of this header.
 namespace tflite {
 class FlatBufferModel;
 class Interpreter;
 }
+struct TfLiteDelegate;
+
+enum class CpuPrecision {
+    Fp32,  // default kernels (XNNPACK applied implicitly by LiteRT)
+    Fp16,  // explicit XNNPACK delegate with FORCE_FP16 (native on ARMv8.2+)
+};
 
 // CPU-only LiteRT backend — the cross-platform ARM baseline.
-// No delegate is applied explicitly; XNNPACK (built into LiteRT by default)
+// By default no delegate is applied explicitly; XNNPACK (built into LiteRT by default)
 // provides NEON-optimized kernels on ARM64/ARMv7 without extra configuration.
 //
+// Tensor types: uint8 / int8 / float32 / float16 inputs are filled from RGB
+// pixels (quantized or normalized as needed), and uint8 / int8 / float16 /
+// int32 outputs are dequantized into float buffers on first access, so
+// quantized models work unchanged behind the float output_data() interface.
+//
+// Dynamic input: fully-convolutional models can run at the frame's native
+// resolution instead of being rescaled. Each distinct input shape gets its own
+// prepared interpreter (ResizeInputTensor + AllocateTensors once), kept in a
+// small LRU so cameras at different resolutions never re-allocate per frame.
+// Enabled automatically when the model's input signature has dynamic H/W,
+// unless set_dynamic_input() decided explicitly.
+//
 // Swap for GpuBackend / NpuBackend when targeting a platform with a suitable
 // delegate; all three share the same InferenceBackend interface.
 class CpuBackend : public InferenceBackend {
@@ -25,6 +45,9 @@ public:
     bool prepare()  override;
     void teardown() override;
     bool process(const uint8_t* rgb_data, int width, int height) override;
+    bool process_batch(const uint8_t* rgb_data, int batch, int width, int height) override;
+    bool input_shape(int& batch, int& height, int& width, int& channels) const override;
+    bool accepts_any_input_size() const override { return dynamic_input_; }
 
     int          output_count()                  const override;
     const float* output_data(int tensor_idx = 0) const override;
@@ -33,10 +56,53 @@ public:
     // Optional: set thread count before prepare(). Default: 1.
     void set_num_threads(int n) { num_threads_ = n; }
 
+    // Optional: before prepare(). Default: Fp32.
+    void set_precision(CpuPrecision p) { precision_ = p; }
+
+    // Optional: before prepare(). false runs LiteRT's builtin kernels only
+    // (no XNNPACK; Fp16 is then ignored) — a baseline for benchmarking.
+    void set_use_xnnpack(bool enable) { use_xnnpack_ = enable; }
+
+    // Pixel normalization for float / fp16 / int8 input tensors:
+    // value = (pixel − mean) / std. Default maps pixels to [0, 1].
+    // uint8 input tensors always receive raw pixels.
+    void set_input_normalization(float mean, float std) { input_mean_ = mean; input_std_ = std; }
+
+    // Optional: before prepare(). Run frames at their own resolution (or
+    // not), whatever the model signature says.
+    void set_dynamic_input(bool enable) override {
+        dynamic_input_    = enable;
+        dynamic_explicit_ = true;
+    }
+    // Optional: before prepare(). Prepared interpreters kept, one per input
+    // shape. Default: 4.
+    void set_input_cache_size(int shapes) override { cache_size_ = shapes < 1 ? 1 : shapes; }
+
+    // Build the interpreter for a known camera resolution ahead of the first
+    // frame (dynamic input only). Returns false if the model cannot run at it.
+    bool prewarm_input_size(int width, int height) override;
+
 private:
-    std::string model_path_;
-    int         num_threads_ = 1;
+    struct Instance;  // interpreter + delegate + output cache for one input shape
+
+    std::unique_ptr<Instance> build_instance(int height, int width) const;
+    bool select_instance(int width, int height);
+    bool fill_input(const uint8_t* rgb_data, size_t bytes);
+    bool invoke();
+
+    std::string  model_path_;
+    int          num_threads_ = 1;
+    CpuPrecision precision_   = CpuPrecision::Fp32;
+    bool         use_xnnpack_ = true;
+    float        input_mean_  = 0.f;
+    float        input_std_   = 255.f;
+    bool         dynamic_input_ = false;
+    bool         dynamic_explicit_ = false;  // set_dynamic_input() called
+    int          cache_size_    = 4;
 
     std::unique_ptr<tflite::FlatBufferModel> model_;
-    std::unique_ptr<tflite::Interpreter>     interpreter_;
+
+    // Most recently used first; front() is the active instance.
+    std::list<std::unique_ptr<Instance>> instances_;
+    Instance*                            active_ = nullptr;
 };
@@ -0,0 +1,50 @@
+#include "detection.h"
+#include "inference_engine.h"
+
+#include <algorithm>
+
+std::vector<Detection> decode_ssd_detections(const InferenceEngine& engine,
+                                             float min_score,
+                                             int   max_detections,
+                                             const SsdOutputLayout& layout) {
+    std::vector<Detection> out;
+
+    const float* boxes   = engine.output_data(layout.boxes);
+    const float* classes = engine.output_data(layout.classes);
+    const float* scores  = engine.output_data(layout.scores);
+    const float* count   = engine.output_data(layout.count);
+    if (!boxes || !classes || !scores || !count) return out;
+
+    // Never trust the count tensor beyond what the buffers actually hold.
+    int n = static_cast<int>(count[0]);
+    n = std::min(n, engine.output_size(layout.boxes) / 4);
+    n = std::min(n, engine.output_size(layout.scores));
+    n = std::min(n, engine.output_size(layout.classes));
+
+    for (int i = 0; i < n; ++i) {
+        if (scores[i] < min_score) continue;
+        Detection d;
+        d.y0       = std::clamp(boxes[i * 4 + 0], 0.f, 1.f);
+        d.x0       = std::clamp(boxes[i * 4 + 1], 0.f, 1.f);
+        d.y1       = std::clamp(boxes[i * 4 + 2], 0.f, 1.f);
+        d.x1       = std::clamp(boxes[i * 4 + 3], 0.f, 1.f);
+        d.score    = scores[i];
+        d.class_id = static_cast<int>(classes[i]);
+        if (d.x1 > d.x0 && d.y1 > d.y0) out.push_back(d);
+    }
+
+    std::sort(out.begin(), out.end(),
+              [](const Detection& a, const Detection& b) { return a.score > b.score; });
+    if ((int)out.size() > max_detections) out.resize(max_detections);
+    return out;
+}
+
+float iou(const Detection& a, const Detection& b) {
+    const float ix0 = std::max(a.x0, b.x0);
+    const float iy0 = std::max(a.y0, b.y0);
+    const float ix1 = std::min(a.x1, b.x1);
+    const float iy1 = std::min(a.y1, b.y1);
+    const float inter = std::max(0.f, ix1 - ix0) * std::max(0.f, iy1 - iy0);
+    const float uni   = a.width() * a.height() + b.width() * b.height() - inter;
+    return uni > 0.f ? inter / uni : 0.f;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+class InferenceEngine;
+
+// One object detection. Box corners are normalized to [0, 1] relative to the
+// frame the detector saw, so they apply unchanged to any rescaled copy.
+struct Detection {
+    float x0 = 0.f, y0 = 0.f;  // top-left
+    float x1 = 0.f, y1 = 0.f;  // bottom-right
+    float score    = 0.f;
+    int   class_id = -1;
+
+    float width()  const { return x1 - x0; }
+    float height() const { return y1 - y0; }
+};
+
+// Output tensor indices of a TFLite_Detection_PostProcess head.
+// Defaults match TF1 SSD exports (boxes, classes, scores, count); TF2 exports
+// commonly use {1, 3, 0, 2}.
+struct SsdOutputLayout {
+    int boxes   = 0;  // [1, N, 4] as ymin, xmin, ymax, xmax
+    int classes = 1;  // [1, N]
+    int scores  = 2;  // [1, N]
+    int count   = 3;  // [1]
+};
+
+// Decode the last process() result of an SSD-style detector.
+// Detections below min_score are dropped; at most max_detections are returned,
+// highest score first.
+std::vector<Detection> decode_ssd_detections(const InferenceEngine& engine,
+                                             float min_score      = 0.5f,
+                                             int   max_detections = 32,
+                                             const SsdOutputLayout& layout = {});
+
+// Intersection-over-union of two boxes in the same coordinate space.
+float iou(const Detection& a, const Detection& b);
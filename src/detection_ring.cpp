@@ -0,0 +1,155 @@
+#include "detection_ring.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <new>
+
+static uint32_t round_up_pow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+static int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------------------------------------------------------------------------
+// DetectionRing
+// ---------------------------------------------------------------------------
+
+bool DetectionRing::create(uint32_t capacity) {
+    capacity = round_up_pow2(std::max<uint32_t>(capacity, 2));
+    const size_t bytes = sizeof(ShmDetectionRingHeader) + size_t{capacity} * sizeof(ShmDetectionSlot);
+    if (!shm_.create("rtsp-detections", bytes)) return false;
+
+    // memfd pages start zeroed: every seq is 0 ("never written").
+    header_ = new (shm_.data()) ShmDetectionRingHeader{};
+    header_->magic     = kDetectionRingMagic;
+    header_->version   = kDetectionRingVersion;
+    header_->capacity  = capacity;
+    header_->slot_size = sizeof(ShmDetectionSlot);
+    slots_ = reinterpret_cast<ShmDetectionSlot*>(header_ + 1);
+
+    std::cout << "[DetectionRing] " << capacity << " records at " << path() << "\n";
+    return true;
+}
+
+void DetectionRing::publish(const FrameMeta& frame, const std::vector<Detection>& detections) {
+    if (!header_) return;
+
+    const uint64_t ticket = header_->write_ticket.fetch_add(1, std::memory_order_relaxed);
+    ShmDetectionSlot& s   = slots_[ticket & (header_->capacity - 1)];
+
+    // A producer a full lap ahead already owns this slot: drop this record
+    // rather than roll the slot back (readers count it as dropped).
+    uint64_t cur = s.seq.load(std::memory_order_relaxed);
+    do {
+        if (cur >= 2 * ticket + 1) return;
+    } while (!s.seq.compare_exchange_weak(cur, 2 * ticket + 1, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ShmDetectionRecord& r = s.record;
+    r.slot         = frame.slot;
+    r.pts_ns       = frame.pts_ns;
+    r.frame_index  = frame.frame_index;
+    r.completed_ns = monotonic_ns();
+    r.count        = static_cast<uint32_t>(std::min<size_t>(detections.size(), kMaxRecordDetections));
+    for (uint32_t i = 0; i < r.count; ++i) {
+        const Detection& d = detections[i];
+        r.det[i] = {d.x0, d.y0, d.x1, d.y1, d.score, d.class_id};
+    }
+
+    s.seq.store(2 * ticket + 2, std::memory_order_release);
+
+    // Paired with the reader's waiters++ / futex_word load (both seq_cst), so
+    // either the reader sees the new word or we see its waiter count.
+    header_->futex_word.fetch_add(1, std::memory_order_seq_cst);
+    if (header_->waiters.load(std::memory_order_seq_cst) > 0) futex_wake_all(&header_->futex_word);
+}
+
+uint64_t DetectionRing::published() const {
+    return header_ ? header_->write_ticket.load(std::memory_order_relaxed) : 0;
+}
+
+// ---------------------------------------------------------------------------
+// DetectionRingReader
+// ---------------------------------------------------------------------------
+
+bool DetectionRingReader::open(const std::string& path) {
+    if (!shm_.open(path, true)) return false;
+    if (shm_.size() < sizeof(ShmDetectionRingHeader)) {
+        std::cerr << "[DetectionRingReader] Segment too small: " << path << "\n";
+        shm_.close();
+        return false;
+    }
+    header_ = static_cast<ShmDetectionRingHeader*>(shm_.data());
+    if (header_->magic != kDetectionRingMagic || header_->version != kDetectionRingVersion ||
+        header_->slot_size != sizeof(ShmDetectionSlot) ||
+        shm_.size() < sizeof(ShmDetectionRingHeader) + size_t{header_->capacity} * sizeof(ShmDetectionSlot)) {
+        std::cerr << "[DetectionRingReader] Not a compatible detection ring: " << path << "\n";
+        header_ = nullptr;
+        shm_.close();
+        return false;
+    }
+    slots_   = reinterpret_cast<ShmDetectionSlot*>(header_ + 1);
+    cursor_  = header_->write_ticket.load(std::memory_order_acquire);
+    dropped_ = 0;
+    return true;
+}
+
+DetectionRingReader::Poll DetectionRingReader::try_read(ShmDetectionRecord& out) {
+    const ShmDetectionSlot& s = slots_[cursor_ & (header_->capacity - 1)];
+    const uint64_t want = 2 * cursor_ + 2;
+
+    const uint64_t s1 = s.seq.load(std::memory_order_acquire);
+    if (s1 < want) return Poll::Empty;   // not yet (fully) written
+    if (s1 > want) return Poll::Lapped;  // already overwritten
+
+    out = s.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) != s1) return Poll::Lapped;  // torn copy
+
+    ++cursor_;
+    return Poll::Ready;
+}
+
+bool DetectionRingReader::next(ShmDetectionRecord& out, int timeout_ms) {
+    if (!header_) return false;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (true) {
+        Poll p = try_read(out);
+        if (p == Poll::Empty && timeout_ms != 0) {
+            header_->waiters.fetch_add(1, std::memory_order_seq_cst);
+            const uint32_t word = header_->futex_word.load(std::memory_order_seq_cst);
+            p = try_read(out);  // re-check after registering as a waiter
+            if (p == Poll::Empty) {
+                int wait_ms = -1;
+                if (timeout_ms > 0) {
+                    wait_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now()).count());
+                    wait_ms = std::max(wait_ms, 0);
+                }
+                futex_wait(&header_->futex_word, word, wait_ms);
+            }
+            header_->waiters.fetch_sub(1, std::memory_order_seq_cst);
+            if (p == Poll::Empty) {
+                if (timeout_ms > 0 && std::chrono::steady_clock::now() >= deadline) return false;
+                continue;
+            }
+        }
+
+        if (p == Poll::Ready) return true;
+        if (p == Poll::Empty) return false;  // poll mode
+
+        // Lapped: skip to the oldest record that can still be intact.
+        const uint64_t head   = header_->write_ticket.load(std::memory_order_acquire);
+        const uint64_t oldest = head > header_->capacity ? head - header_->capacity : 0;
+        const uint64_t resume = std::max(cursor_ + 1, oldest);
+        dropped_ += resume - cursor_;
+        cursor_   = resume;
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "detection.h"
+#include "frame_consumer.h"
+#include "shm_util.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Wire format. Plain fixed-size structs so readers in other processes (or
+// other languages) can use the mapping directly; bump kDetectionRingVersion
+// on any layout change.
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t kDetectionRingMagic   = 0x52444554;  // "TEDR"
+constexpr uint32_t kDetectionRingVersion = 1;
+constexpr int      kMaxRecordDetections  = 32;
+
+struct ShmDetection {
+    float   x0, y0, x1, y1;  // normalized to [0, 1]
+    float   score;
+    int32_t class_id;
+};
+
+// All detections of one inferred frame.
+struct ShmDetectionRecord {
+    int32_t      slot;
+    uint32_t     count;         // valid entries in det[]
+    int64_t      pts_ns;        // frame PTS, -1 if none
+    uint64_t     frame_index;
+    int64_t      completed_ns;  // CLOCK_MONOTONIC when inference finished
+    ShmDetection det[kMaxRecordDetections];
+};
+
+struct alignas(64) ShmDetectionSlot {
+    // Seqlock: 2·ticket + 1 while being written, 2·ticket + 2 once published.
+    std::atomic<uint64_t> seq;
+    ShmDetectionRecord    record;
+};
+
+struct alignas(64) ShmDetectionRingHeader {
+    uint32_t              magic;
+    uint32_t              version;
+    uint32_t              capacity;    // slots, power of two
+    uint32_t              slot_size;   // sizeof(ShmDetectionSlot)
+    alignas(64) std::atomic<uint64_t> write_ticket;  // next ticket to claim
+    alignas(64) std::atomic<uint32_t> futex_word;    // bumped on every publish
+    std::atomic<uint32_t> waiters;                   // readers blocked in futex_wait
+    // ShmDetectionSlot slots[capacity] follow.
+};
+
+// ---------------------------------------------------------------------------
+// Writer (this process)
+// ---------------------------------------------------------------------------
+
+// Multi-producer broadcast ring of per-frame detection records in a memfd.
+//
+// Producers (scheduler worker, graph runner, …) claim a ticket with one
+// fetch_add and publish through the slot's seqlock — no locks, no syscalls
+// unless a reader is blocked. The ring never waits for readers: a slow reader
+// is lapped and resynchronizes to the oldest record still present, so a
+// stalled consumer process cannot back-pressure inference.
+class DetectionRing {
+public:
+    DetectionRing() = default;
+
+    // capacity is rounded up to a power of two.
+    bool create(uint32_t capacity = 1024);
+
+    // Detections beyond kMaxRecordDetections are dropped (lowest score last
+    // if the input is sorted, as decode_ssd_detections() returns it).
+    void publish(const FrameMeta& frame, const std::vector<Detection>& detections);
+
+    // Path for DetectionRingReader::open() in another process.
+    std::string path() const { return shm_.path(); }
+
+    uint64_t published() const;
+
+private:
+    ShmSegment              shm_;
+    ShmDetectionRingHeader* header_ = nullptr;
+    ShmDetectionSlot*       slots_  = nullptr;
+};
+
+// ---------------------------------------------------------------------------
+// Reader (any local process)
+// ---------------------------------------------------------------------------
+
+class DetectionRingReader {
+public:
+    // Starts at the newest record; earlier records are not replayed.
+    bool open(const std::string& path);
+
+    // Copy the next record. Waits up to timeout_ms (< 0 forever, 0 polls).
+    // Returns false on timeout.
+    bool next(ShmDetectionRecord& out, int timeout_ms = -1);
+
+    // Records overwritten before this reader got to them.
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    enum class Poll { Ready, Empty, Lapped };
+    Poll try_read(ShmDetectionRecord& out);
+
+    ShmSegment              shm_;
+    ShmDetectionRingHeader* header_  = nullptr;
+    ShmDetectionSlot*       slots_   = nullptr;
+    uint64_t                cursor_  = 0;  // next ticket to read
+    uint64_t                dropped_ = 0;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// DRM fourcc codes (drm_fourcc.h) for the layouts VideoRenderer can import.
+constexpr uint32_t drm_fourcc(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 |
+           static_cast<uint32_t>(c) << 16 | static_cast<uint32_t>(d) << 24;
+}
+constexpr uint32_t kDrmFormatXRGB8888 = drm_fourcc('X', 'R', '2', '4');  // GStreamer BGRx
+constexpr uint32_t kDrmFormatARGB8888 = drm_fourcc('A', 'R', '2', '4');  // BGRA
+constexpr uint32_t kDrmFormatXBGR8888 = drm_fourcc('X', 'B', '2', '4');  // RGBx
+constexpr uint32_t kDrmFormatABGR8888 = drm_fourcc('A', 'B', '2', '4');  // RGBA
+constexpr uint32_t kDrmFormatNV12     = drm_fourcc('N', 'V', '1', '2');
+
+// A decoded frame in DMABuf memory, described for EGL_EXT_image_dma_buf_import.
+// Carries no GStreamer types: `keepalive` owns whatever backs the fds (the
+// GstBuffer) and is released once the renderer no longer samples the frame.
+struct DmabufFrame {
+    static constexpr int kMaxPlanes = 2;
+
+    uint32_t drm_format = 0;
+    int      width      = 0;
+    int      height     = 0;
+    int      num_planes = 0;
+    int      fd[kMaxPlanes]     = {-1, -1};
+    uint32_t offset[kMaxPlanes] = {0, 0};
+    uint32_t stride[kMaxPlanes] = {0, 0};
+
+    std::shared_ptr<void> keepalive;
+};
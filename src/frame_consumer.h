@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Identity and timing of one decoded frame. Travels with the pixels through
+// consumers and inference so results can be matched to the exact frame.
+struct FrameMeta {
+    int      slot        = 0;   // stream id (renderer grid slot)
+    int64_t  pts_ns      = -1;  // GstBuffer PTS in nanoseconds, -1 if none
+    uint64_t frame_index = 0;   // frames delivered by this stream so far
+};
+
+// Receiver of decoded RGB frames from RtspStream, alongside (or instead of)
+// the VideoRenderer.
+//
+// on_frame() runs while the buffer is mapped, on a thread that depends on the
+// stream's SampleDelivery: the GStreamer streaming thread (Signal), the
+// stream's own pull thread (Pull), or a shared SamplePump worker (Pool).
+// Implementations must be thread-safe, must not block, and must copy
+// whatever they need before returning.
+class FrameConsumer {
+public:
+    virtual ~FrameConsumer() = default;
+
+    // rgb_data: height rows of width × 3 bytes, row-major uint8, each row
+    // starting `stride` bytes after the previous one (stride ≥ width × 3;
+    // decoder pools pad rows for alignment).
+    virtual void on_frame(const FrameMeta& meta, const uint8_t* rgb_data,
+                          int width, int height, int stride) = 0;
+};
+
+// Copy a possibly row-padded RGB frame into a tightly packed buffer of
+// width × height × 3 bytes.
+inline void copy_packed_rgb(uint8_t* dst, const uint8_t* src, int width, int height, int stride) {
+    const size_t row = static_cast<size_t>(width) * 3;
+    if (static_cast<size_t>(stride) == row) {
+        std::memcpy(dst, src, row * height);
+        return;
+    }
+    for (int y = 0; y < height; ++y)
+        std::memcpy(dst + row * y, src + static_cast<size_t>(stride) * y, row);
+}
@@ -0,0 +1,272 @@
+#include "frame_export.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <new>
+
+#include <signal.h>
+#include <unistd.h>
+
+static uint64_t align_up(uint64_t v, uint64_t a) { return (v + a - 1) / a * a; }
+
+static constexpr uint64_t kHandleSlotBits = 16;
+static constexpr uint64_t kHandleSlotMask = (uint64_t{1} << kHandleSlotBits) - 1;
+static constexpr uint32_t kLeaseReclaiming = 0xffffffffu;  // lease pid while being reclaimed
+
+static ShmFrameSlot* ring_slot(ShmFrameExportHeader* header, uint32_t i) {
+    return reinterpret_cast<ShmFrameSlot*>(reinterpret_cast<uint8_t*>(header) +
+                                           header->first_slot + header->slot_stride * i);
+}
+
+// Readers move `latest` from several streaming threads: only ever forward.
+static void publish_latest(std::atomic<uint64_t>& latest, uint64_t handle) {
+    uint64_t current = latest.load(std::memory_order_relaxed);
+    while ((current >> kHandleSlotBits) < (handle >> kHandleSlotBits) &&
+           !latest.compare_exchange_weak(current, handle, std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+    }
+}
+
+static bool process_gone(uint32_t pid) {
+    return kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+}
+
+// Hand back the pins of every lease whose process has exited. A pin is
+// recorded after its refcount is taken and cleared before it is dropped, so
+// a crash can leak at most that one pin, never drop one twice.
+static void reclaim_dead_readers(ShmFrameExportHeader* header) {
+    for (ShmReaderLease& lease : header->readers) {
+        uint32_t pid = lease.pid.load(std::memory_order_acquire);
+        if (pid == 0 || pid == kLeaseReclaiming || !process_gone(pid)) continue;
+        if (!lease.pid.compare_exchange_strong(pid, kLeaseReclaiming, std::memory_order_acquire))
+            continue;  // someone else got there first
+        int released = 0;
+        for (auto& pin : lease.pins) {
+            const uint32_t entry = pin.exchange(0, std::memory_order_acq_rel);
+            if (entry == 0 || entry > header->slot_count) continue;
+            ring_slot(header, entry - 1)->refs.fetch_sub(1, std::memory_order_release);
+            ++released;
+        }
+        lease.pid.store(0, std::memory_order_release);
+        std::cerr << "[FrameExport] Reader " << pid << " exited holding " << released
+                  << " frame(s); released\n";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// FrameExport
+// ---------------------------------------------------------------------------
+
+bool FrameExport::create(int slot_count, int max_width, int max_height) {
+    if (slot_count < 2 || slot_count > static_cast<int>(kHandleSlotMask) || max_width <= 0 || max_height <= 0) {
+        std::cerr << "[FrameExport] Invalid geometry\n";
+        return false;
+    }
+    const uint64_t frame_bytes = uint64_t{3} * max_width * max_height;
+    const uint64_t first       = align_up(sizeof(ShmFrameExportHeader), 4096);
+    const uint64_t stride      = align_up(sizeof(ShmFrameSlot) + frame_bytes, 4096);
+    if (!shm_.create("rtsp-frames", first + stride * slot_count)) return false;
+
+    header_ = new (shm_.data()) ShmFrameExportHeader{};
+    header_->magic           = kFrameExportMagic;
+    header_->version         = kFrameExportVersion;
+    header_->slot_count      = static_cast<uint32_t>(slot_count);
+    header_->max_frame_bytes = static_cast<uint32_t>(frame_bytes);
+    header_->slot_stride     = stride;
+    header_->first_slot      = first;
+    for (int i = 0; i < slot_count; ++i) new (slot(i)) ShmFrameSlot{};
+
+    std::cout << "[FrameExport] " << slot_count << " × " << max_width << "x" << max_height
+              << " frames at " << path() << "\n";
+    return true;
+}
+
+ShmFrameSlot* FrameExport::slot(uint32_t i) const {
+    return ring_slot(header_, i);
+}
+
+void FrameExport::on_frame(const FrameMeta& meta, const uint8_t* rgb_data,
+                           int width, int height, int stride) {
+    if (!header_) return;
+    const size_t bytes = static_cast<size_t>(width) * height * 3;
+    if (bytes > header_->max_frame_bytes) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Claim the next slot nobody has pinned; never wait for readers. If all
+    // are pinned, dead readers may be the reason: reclaim and look once more.
+    const uint32_t n = header_->slot_count;
+    for (uint32_t attempt = 0; attempt < 2 * n; ++attempt) {
+        if (attempt == n) {
+            const int64_t now  = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            int64_t       last = last_reclaim_ns_.load(std::memory_order_relaxed);
+            if (now - last < 1000000000 ||
+                !last_reclaim_ns_.compare_exchange_strong(last, now, std::memory_order_relaxed))
+                break;
+            reclaim_dead_readers(header_);
+        }
+        const uint32_t i = next_slot_.fetch_add(1, std::memory_order_relaxed) % n;
+        ShmFrameSlot*  s = slot(i);
+        uint32_t expected = 0;
+        if (!s->refs.compare_exchange_strong(expected, kFrameSlotWriter, std::memory_order_acquire))
+            continue;
+
+        s->stream      = meta.slot;
+        s->width       = static_cast<uint32_t>(width);
+        s->height      = static_cast<uint32_t>(height);
+        s->pts_ns      = meta.pts_ns;
+        s->frame_index = meta.frame_index;
+        copy_packed_rgb(reinterpret_cast<uint8_t*>(s + 1), rgb_data, width, height, stride);
+
+        const uint64_t seq = header_->publish_seq.fetch_add(1, std::memory_order_relaxed) + 1;
+        s->seq.store(seq, std::memory_order_release);
+        // fetch_and keeps any transient reader increments that bounced off the writer bit.
+        s->refs.fetch_and(~kFrameSlotWriter, std::memory_order_release);
+
+        const uint64_t handle = (seq << kHandleSlotBits) | i;
+        if (meta.slot >= 0 && meta.slot < kMaxExportStreams)
+            publish_latest(header_->latest[meta.slot], handle);
+        publish_latest(header_->latest_any, handle);
+        published_.fetch_add(1, std::memory_order_relaxed);
+
+        header_->futex_word.fetch_add(1, std::memory_order_seq_cst);
+        if (header_->waiters.load(std::memory_order_seq_cst) > 0) futex_wake_all(&header_->futex_word);
+        return;
+    }
+    dropped_.fetch_add(1, std::memory_order_relaxed);  // every slot pinned
+}
+
+// ---------------------------------------------------------------------------
+// FrameExportReader
+// ---------------------------------------------------------------------------
+
+FrameExportReader::~FrameExportReader() { close(); }
+
+bool FrameExportReader::open(const std::string& path) {
+    close();
+    if (!shm_.open(path, true)) return false;  // writable: refcounts live in the mapping
+    header_ = static_cast<ShmFrameExportHeader*>(shm_.data());
+    if (shm_.size() < sizeof(ShmFrameExportHeader) ||
+        header_->magic != kFrameExportMagic || header_->version != kFrameExportVersion ||
+        shm_.size() < header_->first_slot + header_->slot_stride * header_->slot_count) {
+        std::cerr << "[FrameExportReader] Not a compatible frame ring: " << path << "\n";
+        header_ = nullptr;
+        shm_.close();
+        return false;
+    }
+
+    const uint32_t pid = static_cast<uint32_t>(getpid());
+    for (int pass = 0; pass < 2 && !lease_; ++pass) {
+        if (pass == 1) reclaim_dead_readers(header_);
+        for (ShmReaderLease& lease : header_->readers) {
+            uint32_t free_pid = 0;
+            if (lease.pid.compare_exchange_strong(free_pid, pid, std::memory_order_acq_rel)) {
+                lease_ = &lease;
+                break;
+            }
+        }
+    }
+    if (!lease_) {
+        std::cerr << "[FrameExportReader] All " << kMaxExportReaders << " reader leases in use: " << path << "\n";
+        header_ = nullptr;
+        shm_.close();
+        return false;
+    }
+    std::fill(std::begin(last_seq_), std::end(last_seq_), 0);
+    return true;
+}
+
+void FrameExportReader::close() {
+    if (lease_) {
+        for (auto& pin : lease_->pins) {
+            const uint32_t entry = pin.exchange(0, std::memory_order_acq_rel);
+            if (entry) slot(entry - 1)->refs.fetch_sub(1, std::memory_order_release);
+        }
+        lease_->pid.store(0, std::memory_order_release);
+        lease_ = nullptr;
+    }
+    header_ = nullptr;
+    shm_.close();
+}
+
+ShmFrameSlot* FrameExportReader::slot(uint32_t i) const {
+    return ring_slot(header_, i);
+}
+
+FrameExportReader::PinResult FrameExportReader::try_pin(uint64_t handle, ExportedFrame& out) {
+    const uint32_t i = static_cast<uint32_t>(handle & kHandleSlotMask);
+    if (i >= header_->slot_count) return PinResult::Stale;
+    ShmFrameSlot* s = slot(i);
+
+    std::atomic<uint32_t>* record = nullptr;
+    for (auto& pin : lease_->pins)
+        if (pin.load(std::memory_order_relaxed) == 0) { record = &pin; break; }
+    if (!record) return PinResult::Full;  // kMaxReaderPins frames already held
+
+    const uint32_t prev = s->refs.fetch_add(1, std::memory_order_acquire);
+    if ((prev & kFrameSlotWriter) || s->seq.load(std::memory_order_acquire) != (handle >> kHandleSlotBits)) {
+        s->refs.fetch_sub(1, std::memory_order_release);  // being rewritten or already replaced
+        return PinResult::Stale;
+    }
+    record->store(i + 1, std::memory_order_release);
+
+    out.rgb              = reinterpret_cast<const uint8_t*>(s + 1);
+    out.width            = static_cast<int>(s->width);
+    out.height           = static_cast<int>(s->height);
+    out.meta.slot        = s->stream;
+    out.meta.pts_ns      = s->pts_ns;
+    out.meta.frame_index = s->frame_index;
+    out.handle           = handle;
+    return PinResult::Pinned;
+}
+
+bool FrameExportReader::acquire(ExportedFrame& out, int stream, int timeout_ms) {
+    if (!header_ || stream >= kMaxExportStreams) return false;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    std::atomic<uint64_t>& latest = stream < 0 ? header_->latest_any : header_->latest[stream];
+    uint64_t& last = last_seq_[stream < 0 ? 0 : stream + 1];
+
+    while (true) {
+        const uint32_t word   = header_->futex_word.load(std::memory_order_seq_cst);
+        const uint64_t handle = latest.load(std::memory_order_acquire);
+        if ((handle >> kHandleSlotBits) > last) {
+            const PinResult pin = try_pin(handle, out);
+            if (pin == PinResult::Full) return false;
+            // Stale: other streams reused the slot. Nothing newer to pin
+            // until `latest` moves, so wait for that like any other reader.
+            last = handle >> kHandleSlotBits;
+            if (pin == PinResult::Pinned) return true;
+        }
+        if (timeout_ms == 0) return false;
+
+        header_->waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (latest.load(std::memory_order_seq_cst) == handle) {
+            int wait_ms = -1;
+            if (timeout_ms > 0) {
+                wait_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count());
+                wait_ms = std::max(wait_ms, 0);
+            }
+            futex_wait(&header_->futex_word, word, wait_ms);
+        }
+        header_->waiters.fetch_sub(1, std::memory_order_seq_cst);
+        if (timeout_ms > 0 && std::chrono::steady_clock::now() >= deadline &&
+            (latest.load(std::memory_order_acquire) >> kHandleSlotBits) <= last)
+            return false;
+    }
+}
+
+void FrameExportReader::release(ExportedFrame& frame) {
+    if (!header_ || !frame.rgb) return;
+    const uint32_t i = static_cast<uint32_t>(frame.handle & kHandleSlotMask);
+    for (auto& pin : lease_->pins) {
+        uint32_t entry = i + 1;
+        if (pin.compare_exchange_strong(entry, 0, std::memory_order_acq_rel)) break;
+    }
+    slot(i)->refs.fetch_sub(1, std::memory_order_release);
+    frame.rgb = nullptr;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "frame_consumer.h"
+#include "shm_util.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// Wire format (bump kFrameExportVersion on any layout change)
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t kFrameExportMagic   = 0x58454652;  // "RFEX"
+constexpr uint32_t kFrameExportVersion = 2;
+constexpr int      kMaxExportStreams   = 64;
+constexpr int      kMaxExportReaders   = 32;
+constexpr int      kMaxReaderPins      = 8;            // frames one reader may hold at once
+constexpr uint32_t kFrameSlotWriter    = 0x80000000u;  // refs bit held while writing
+
+// A published frame is addressed by (seq << 16 | slot index); seq is the
+// global publish counter, so a stale handle is detected by comparing seq.
+struct alignas(64) ShmFrameSlot {
+    std::atomic<uint32_t> refs;      // reader pins; kFrameSlotWriter while being filled
+    int32_t               stream;
+    uint32_t              width;
+    uint32_t              height;    // pixels are width × height × 3, tightly packed
+    std::atomic<uint64_t> seq;       // publish counter of the frame in this slot, 0 = empty
+    int64_t               pts_ns;
+    uint64_t              frame_index;
+};
+
+// One per open FrameExportReader: the pins it holds, so the writer can hand
+// back those of a reader that died without releasing them.
+struct alignas(64) ShmReaderLease {
+    std::atomic<uint32_t> pid;                    // 0: free
+    std::atomic<uint32_t> pins[kMaxReaderPins];   // pinned slot index + 1, 0: unused
+};
+
+struct alignas(64) ShmFrameExportHeader {
+    uint32_t              magic;
+    uint32_t              version;
+    uint32_t              slot_count;
+    uint32_t              max_frame_bytes;
+    uint64_t              slot_stride;    // bytes from one slot to the next
+    uint64_t              first_slot;     // offset of slot 0 from the mapping start
+    alignas(64) std::atomic<uint64_t> publish_seq;
+    std::atomic<uint32_t> futex_word;     // bumped on every publish
+    std::atomic<uint32_t> waiters;
+    std::atomic<uint64_t> latest_any;
+    std::atomic<uint64_t> latest[kMaxExportStreams];  // per stream (slot id)
+    ShmReaderLease        readers[kMaxExportReaders];
+    // Slots follow at first_slot: ShmFrameSlot header, then pixel data.
+};
+
+// ---------------------------------------------------------------------------
+// Writer: attach to RtspStreamManager::add_consumer()
+// ---------------------------------------------------------------------------
+
+// Publishes decoded RGB frames of every stream into a memfd frame ring so
+// sidecar processes read them in place, without re-decoding or sockets.
+//
+// Each frame costs one copy into a free slot. Readers pin a slot by bumping
+// its refcount; the writer skips pinned slots and drops the frame (counted)
+// only if every slot is pinned, so consumers never block the streaming
+// threads and a pinned frame is never overwritten. Pins are recorded in the
+// reader's lease; when every slot is pinned the writer (at most once a
+// second) releases those of reader processes that no longer exist.
+class FrameExport : public FrameConsumer {
+public:
+    FrameExport() = default;
+
+    // slot_count frames of up to max_width × max_height RGB each.
+    bool create(int slot_count, int max_width, int max_height);
+
+    void on_frame(const FrameMeta& meta, const uint8_t* rgb_data,
+                  int width, int height, int stride) override;
+
+    std::string path() const { return shm_.path(); }
+    uint64_t    published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t    dropped()   const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    ShmFrameSlot* slot(uint32_t i) const;
+
+    ShmSegment            shm_;
+    ShmFrameExportHeader* header_ = nullptr;
+    std::atomic<uint32_t> next_slot_{0};
+    std::atomic<int64_t>  last_reclaim_ns_{0};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// ---------------------------------------------------------------------------
+// Reader (any local process)
+// ---------------------------------------------------------------------------
+
+struct ExportedFrame {
+    const uint8_t* rgb    = nullptr;  // valid until release()
+    int            width  = 0;
+    int            height = 0;
+    FrameMeta      meta;
+    uint64_t       handle = 0;
+};
+
+class FrameExportReader {
+public:
+    FrameExportReader() = default;
+    ~FrameExportReader();  // releases the lease and any frames still held
+
+    // Fails if every reader lease is taken by a live process.
+    bool open(const std::string& path);
+    void close();
+
+    // Pin the newest frame of `stream` (-1: of any stream) that is newer than
+    // the last one acquired. Waits up to timeout_ms (< 0 forever, 0 polls).
+    // Every successful acquire() must be paired with release(); at most
+    // kMaxReaderPins frames are held at once; with all of them held it fails
+    // immediately.
+    bool acquire(ExportedFrame& out, int stream = -1, int timeout_ms = -1);
+    void release(ExportedFrame& frame);
+
+private:
+    enum class PinResult { Pinned, Stale, Full };  // Stale: slot rewritten since
+    PinResult try_pin(uint64_t handle, ExportedFrame& out);
+    ShmFrameSlot* slot(uint32_t i) const;
+
+    ShmSegment            shm_;
+    ShmFrameExportHeader* header_ = nullptr;
+    ShmReaderLease*       lease_  = nullptr;
+    uint64_t              last_seq_[kMaxExportStreams + 1] = {};  // [0]: any stream
+};
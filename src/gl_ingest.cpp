@@ -0,0 +1,92 @@
+#include "gl_ingest.h"
+
+#include <iostream>
+
+#if defined(RTSP_HAVE_GST_GL) && defined(RTSP_HAVE_EGL)
+
+#include <gst/gl/egl/gstgldisplay_egl.h>
+#include <gst/gl/gl.h>
+
+std::unique_ptr<GlIngest> GlIngest::create(const GlShareHandles& handles) {
+    if (!handles.egl_display || !handles.egl_context) return nullptr;
+
+    std::unique_ptr<GlIngest> ingest(new GlIngest());
+    ingest->display_ = GST_GL_DISPLAY(
+        gst_gl_display_egl_new_with_egl_display(reinterpret_cast<gpointer>(handles.egl_display)));
+    if (!ingest->display_) return nullptr;
+
+    ingest->app_context_ = gst_gl_context_new_wrapped(
+        ingest->display_, reinterpret_cast<guintptr>(handles.egl_context),
+        GST_GL_PLATFORM_EGL, GST_GL_API_OPENGL3);
+    if (!ingest->app_context_) return nullptr;
+
+    // A wrapped context must describe itself before others can share with it.
+    GError* error = nullptr;
+    gst_gl_context_activate(ingest->app_context_, TRUE);
+    const bool ok = gst_gl_context_fill_info(ingest->app_context_, &error);
+    if (!ok) {
+        std::cerr << "[GlIngest] Cannot share the renderer context: "
+                  << (error ? error->message : "unknown") << "\n";
+        if (error) g_error_free(error);
+        return nullptr;
+    }
+    std::cout << "[GlIngest] GStreamer GL shares the renderer context\n";
+    return ingest;
+}
+
+GlIngest::~GlIngest() {
+    if (app_context_) gst_object_unref(app_context_);
+    if (display_)     gst_object_unref(display_);
+}
+
+void GlIngest::attach(GstElement* pipeline) const {
+    // Set on the bin, the contexts reach every child: glupload finds them
+    // instead of creating a display and context of its own.
+    GstContext* display_ctx = gst_context_new(GST_GL_DISPLAY_CONTEXT_TYPE, TRUE);
+    gst_context_set_gl_display(display_ctx, display_);
+    gst_element_set_context(pipeline, display_ctx);
+    gst_context_unref(display_ctx);
+
+    GstContext* app_ctx = gst_context_new("gst.gl.app_context", TRUE);
+    gst_structure_set(gst_context_writable_structure(app_ctx),
+                      "context", GST_TYPE_GL_CONTEXT, app_context_, nullptr);
+    gst_element_set_context(pipeline, app_ctx);
+    gst_context_unref(app_ctx);
+}
+
+bool GlIngest::wrap(GstBuffer* buffer, int width, int height, GlTextureFrame& out) const {
+    GstMemory* mem = gst_buffer_peek_memory(buffer, 0);
+    if (!gst_is_gl_memory(mem)) return false;
+
+    GstGLContext* ctx = app_context_;
+    out.texture = gst_gl_memory_get_texture_id(reinterpret_cast<GstGLMemory*>(mem));
+    out.width   = width;
+    out.height  = height;
+    // The GL thread may still be converting into the texture: make our
+    // context wait on its sync point. Once we are done, set ours so the pool
+    // does not render into it while our draws are in flight.
+    out.wait = [buffer, ctx] {
+        if (GstGLSyncMeta* sync = gst_buffer_get_gl_sync_meta(buffer)) gst_gl_sync_meta_wait(sync, ctx);
+    };
+    out.done = [buffer, ctx] {
+        if (GstGLSyncMeta* sync = gst_buffer_get_gl_sync_meta(buffer)) gst_gl_sync_meta_set_sync_point(sync, ctx);
+    };
+    out.keepalive = std::shared_ptr<void>(gst_buffer_ref(buffer),
+                                          [](void* b) { gst_buffer_unref(static_cast<GstBuffer*>(b)); });
+    return true;
+}
+
+#else
+
+std::unique_ptr<GlIngest> GlIngest::create(const GlShareHandles&) {
+    std::cerr << "[GlIngest] Built without GStreamer GL/EGL; glupload ingest unavailable\n";
+    return nullptr;
+}
+
+GlIngest::~GlIngest() = default;
+
+void GlIngest::attach(GstElement*) const {}
+
+bool GlIngest::wrap(GstBuffer*, int, int, GlTextureFrame&) const { return false; }
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "video_renderer.h"
+
+#include <gst/gst.h>
+
+#include <memory>
+
+struct _GstGLContext;
+struct _GstGLDisplay;
+
+// GStreamer GL objects wrapping VideoRenderer's context, so pipelines can run
+// glupload ! glcolorconvert on a GStreamer GL thread whose context shares
+// textures with the renderer. Frames then reach the screen as GstGLMemory
+// texture ids: no CPU mapping and no CPU colour conversion.
+//
+// Requires the renderer's EGL context and GStreamer's GL library; create()
+// returns null otherwise and streams keep the mapped path.
+class GlIngest {
+public:
+    // Call on the thread where the renderer's context is current
+    // (VideoRenderer::run_in_context).
+    static std::unique_ptr<GlIngest> create(const GlShareHandles& handles);
+    ~GlIngest();
+
+    // Hand the display and the context to share with to every GL element of
+    // `pipeline`. Before it leaves NULL.
+    void attach(GstElement* pipeline) const;
+
+    // Describe a GLMemory buffer for VideoRenderer::push_texture. False if
+    // the buffer is not GL memory.
+    bool wrap(GstBuffer* buffer, int width, int height, GlTextureFrame& out) const;
+
+private:
+    GlIngest() = default;
+
+    _GstGLDisplay* display_     = nullptr;
+    _GstGLContext* app_context_ = nullptr;  // wrapped renderer context
+};
@@ -35,7 +35,29 @@ public:
     // Returns false on error or if not prepared.
     virtual bool process(const uint8_t* rgb_data, int width, int height) = 0;
 
+    // Run inference on `batch` frames packed back to back (NHWC, uint8).
+    // Backends that cannot change their batch dimension return false and the
+    // caller falls back to one process() per frame.
+    virtual bool process_batch(const uint8_t* /*rgb_data*/, int /*batch*/,
+                               int /*width*/, int /*height*/) { return false; }
+
+    // Model input geometry of tensor 0 (NHWC). Returns false if not prepared.
+    virtual bool input_shape(int& batch, int& height, int& width, int& channels) const = 0;
+
+    // True if process() adapts to any frame size (fully-convolutional model
+    // with dynamic input), so callers should not rescale frames.
+    virtual bool accepts_any_input_size() const { return false; }
+
+    // Optional dynamic-input tuning; backends without it ignore these.
+    // Before prepare(): force dynamic input on/off (overrides the model
+    // signature) and bound the prepared shapes kept. After prepare(): build
+    // a frame size ahead of the first frame.
+    virtual void set_dynamic_input(bool /*enable*/) {}
+    virtual void set_input_cache_size(int /*shapes*/) {}
+    virtual bool prewarm_input_size(int /*width*/, int /*height*/) { return false; }
+
     // Output tensor access — valid until the next process() call.
+    // Quantized / half-precision outputs are dequantized to float by the backend.
     virtual int          output_count()                  const = 0;
     virtual const float* output_data(int tensor_idx = 0) const = 0;
     virtual int          output_size(int tensor_idx = 0) const = 0;  // # of floats
@@ -1,47 +1,158 @@
 #include "inference_engine.h"
-#include "cpu_backend.h"
+#include "backend_registry.h"
+#include "roi_resize.h"
 
 #include <iostream>
 
-InferenceEngine::InferenceEngine(const std::string& model_path, Accelerator accel)
-    : accel_(accel)
+InferenceEngine::InferenceEngine(const std::string& model_path,
+                                 const std::string& backend,
+                                 uint32_t required_caps,
+                                 const EngineInputOptions& input)
+    : preferred_(backend), required_caps_(required_caps), input_(input)
 {
-    switch (accel_) {
-        case Accelerator::CPU:
-            backend_ = std::make_unique<CpuBackend>();
-            break;
-        // case Accelerator::GPU: backend_ = std::make_unique<GpuBackend>(); break;
-        // case Accelerator::NPU: backend_ = std::make_unique<NpuBackend>(); break;
+    std::string name;
+    auto loaded = load(model_path, name);
+    if (!loaded) return;
+    backend_name_ = name;
+    std::atomic_store(&backend_, std::move(loaded));
+    ready_ = true;
+}
+
+InferenceEngine::~InferenceEngine() {
+    if (reload_thread_.joinable()) reload_thread_.join();
+}
+
+// Try registry candidates in order until one prepares. Each backend's deleter
+// tears it down, so whichever holder drops the last reference (engine or an
+// in-flight caller) releases the model.
+std::shared_ptr<InferenceBackend> InferenceEngine::load(const std::string& model_path,
+                                                        std::string& name) const {
+    for (const BackendInfo& info : BackendRegistry::instance().candidates(preferred_, required_caps_)) {
+        std::unique_ptr<InferenceBackend> made = info.factory();
+        if (!made) continue;  // backend unavailable on this machine
+        std::shared_ptr<InferenceBackend> backend(made.release(), [](InferenceBackend* b) {
+            b->teardown();
+            delete b;
+        });
+
+        if (input_.dynamic >= 0) backend->set_dynamic_input(input_.dynamic != 0);
+        backend->set_input_cache_size(input_.cache_size);
+        if (!backend->set_model(model_path)) {
+            std::cerr << "[InferenceEngine] " << info.name << ": set_model failed: " << model_path << "\n";
+            continue;
+        }
+        if (!backend->prepare()) {
+            std::cerr << "[InferenceEngine] " << info.name << ": prepare failed, trying next backend\n";
+            continue;
+        }
+        for (const auto& size : input_.prewarm)
+            if (!backend->prewarm_input_size(size.first, size.second))
+                std::cerr << "[InferenceEngine] " << info.name << ": cannot prewarm "
+                          << size.first << "x" << size.second << "\n";
+        std::cout << "[InferenceEngine] Using backend '" << info.name << "' (" << info.description << ")\n";
+        name = info.name;
+        return backend;
     }
+    std::cerr << "[InferenceEngine] No backend could load " << model_path << "\n";
+    return nullptr;
+}
+
+std::string InferenceEngine::backend_name() const {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    return backend_name_;
+}
+
+bool InferenceEngine::reload(const std::string& model_path) {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    if (reloading_) return false;
+    if (reload_thread_.joinable()) reload_thread_.join();  // previous, already finished
 
-    if (!backend_->set_model(model_path)) {
-        std::cerr << "[InferenceEngine] set_model failed: " << model_path << "\n";
-        return;
+    reloading_ = true;
+    reload_thread_ = std::thread([this, model_path] {
+        std::string name;
+        auto backend = load(model_path, name);
+        std::lock_guard<std::mutex> lock(reload_mutex_);
+        if (!backend) {
+            std::cerr << "[InferenceEngine] Reload failed; keeping current model\n";
+            reloading_ = false;
+            return;
+        }
+        // Loading is what reloading() guards; the swap itself waits for the
+        // next frame, so an idle engine would otherwise refuse every later
+        // reload. A newer reload simply supersedes a pending one.
+        std::cout << "[InferenceEngine] Reloaded " << model_path << "; swapping on next frame\n";
+        pending_       = std::move(backend);
+        pending_name_  = std::move(name);
+        pending_ready_ = true;
+        reloading_     = false;
+    });
+    return true;
+}
+
+std::shared_ptr<InferenceBackend> InferenceEngine::acquire() {
+    if (pending_ready_.load(std::memory_order_acquire)) {
+        std::shared_ptr<InferenceBackend> next;
+        {
+            std::lock_guard<std::mutex> lock(reload_mutex_);
+            next.swap(pending_);
+            backend_name_  = std::move(pending_name_);
+            pending_ready_ = false;
+        }
+        // The previous backend lives on until its last in-flight user returns.
+        std::atomic_store(&backend_, std::move(next));
+        ready_ = true;
     }
-    if (!backend_->prepare()) {
-        std::cerr << "[InferenceEngine] prepare failed\n";
-        return;
+    return current();
+}
+
+bool InferenceEngine::process(const uint8_t* rgb_data, int width, int height) {
+    auto backend = acquire();
+    if (!backend) return false;
+    return backend->process(rgb_data, width, height);
+}
+
+bool InferenceEngine::process_resized(const uint8_t* rgb_data, int width, int height) {
+    auto backend = acquire();  // one backend for the shape query and the run
+    int b = 0, in_h = 0, in_w = 0, in_c = 0;
+    if (!backend || !backend->input_shape(b, in_h, in_w, in_c)) return false;
+    if (in_w == width && in_h == height) return backend->process(rgb_data, width, height);
+
+    // Shape-agnostic backends run the native frame; if that turns out not to
+    // be supported they report it via accepts_any_input_size() going false.
+    if (backend->accepts_any_input_size()) {
+        if (backend->process(rgb_data, width, height)) return true;
+        if (backend->accepts_any_input_size()) return false;
+        if (!backend->input_shape(b, in_h, in_w, in_c)) return false;
     }
-    ready_ = true;
+
+    resize_buf_.resize(static_cast<size_t>(in_w) * in_h * 3);
+    resize_rgb(rgb_data, width, height, 0, resize_buf_.data(), in_w, in_h);
+    return backend->process(resize_buf_.data(), in_w, in_h);
 }
 
-InferenceEngine::~InferenceEngine() {
-    if (backend_) backend_->teardown();
+bool InferenceEngine::process_batch(const uint8_t* rgb_data, int batch, int width, int height) {
+    auto backend = acquire();
+    if (!backend) return false;
+    return backend->process_batch(rgb_data, batch, width, height);
 }
 
-bool InferenceEngine::process(const uint8_t* rgb_data, int width, int height) {
-    if (!ready_) return false;
-    return backend_->process(rgb_data, width, height);
+bool InferenceEngine::input_shape(int& batch, int& height, int& width, int& channels) const {
+    auto backend = current();
+    if (!backend) return false;
+    return backend->input_shape(batch, height, width, channels);
 }
 
 int InferenceEngine::output_count() const {
-    return backend_ ? backend_->output_count() : 0;
+    auto backend = current();
+    return backend ? backend->output_count() : 0;
 }
 
 const float* InferenceEngine::output_data(int idx) const {
-    return backend_ ? backend_->output_data(idx) : nullptr;
+    auto backend = current();
+    return backend ? backend->output_data(idx) : nullptr;
 }
 
 int InferenceEngine::output_size(int idx) const {
-    return backend_ ? backend_->output_size(idx) : 0;
+    auto backend = current();
+    return backend ? backend->output_size(idx) : 0;
 }
@@ -1,41 +1,96 @@
 #pragma once
 
 #include "inference_backend.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
-enum class Accelerator {
-    CPU,
-    // GPU,  // LiteRT GPU delegate (OpenCL/Metal) — add when needed
-    // NPU,  // LiteRT NNAPI / vendor delegate     — add when needed
+// Dynamic-input tuning handed to every backend the engine loads.
+struct EngineInputOptions {
+    int                              dynamic    = -1;  // -1: from the model signature, 0: off, 1: on
+    int                              cache_size = 4;   // prepared input shapes kept
+    std::vector<std::pair<int, int>> prewarm;          // width × height built before the first frame
 };
 
 // Owns and manages a single InferenceBackend strategy.
-// On construction: selects the backend for the requested accelerator,
-// loads the model file, and warms up the interpreter so the first
-// process() call hits cached weights.
+// On construction: picks backends from BackendRegistry (the requested name
+// first, then the rest by priority), and keeps the first one that loads the
+// model and warms up, so the first process() call hits cached weights.
+//
+// reload() hot-swaps the model while streams keep running: the new backend is
+// prepared on a background thread and swapped in at the start of the next
+// process*() call, so no frame sees a half-built model. The old backend is
+// torn down once the last in-flight reference to it is released.
 class InferenceEngine {
 public:
+    // backend: a BackendRegistry name, or "auto" for the highest priority.
+    // required_caps: BackendCaps every candidate must advertise.
     explicit InferenceEngine(const std::string& model_path,
-                             Accelerator accel = Accelerator::CPU);
+                             const std::string& backend = "auto",
+                             uint32_t required_caps = 0,
+                             const EngineInputOptions& input = {});
     ~InferenceEngine();
 
     // True if construction succeeded (model loaded + backend prepared).
     bool ready() const { return ready_; }
 
-    Accelerator accelerator() const { return accel_; }
+    // Registry name of the backend in use (empty if none loaded).
+    std::string backend_name() const;
+
+    // Load model_path on a background thread and swap it in between frames,
+    // using the same backend selection as construction. Returns false if a
+    // reload is still loading. On failure the current model stays active; a
+    // loaded model not yet swapped in is replaced by a newer reload.
+    bool reload(const std::string& model_path);
+
+    // True while a reload() is loading.
+    bool reloading() const { return reloading_.load(); }
 
     // Run one frame through the model.
     // rgb_data: width × height × 3 bytes, row-major uint8.
     bool process(const uint8_t* rgb_data, int width, int height);
 
-    // Output tensor access — valid until the next process() call.
+    // Like process(), but first bilinear-resizes the frame to the model's
+    // input size when they differ (scratch buffer reused across calls).
+    // Backends with dynamic input get the frame at its native size.
+    bool process_resized(const uint8_t* rgb_data, int width, int height);
+
+    // Run `batch` frames packed back to back. Returns false if the backend
+    // cannot batch; callers then fall back to process() per frame.
+    bool process_batch(const uint8_t* rgb_data, int batch, int width, int height);
+
+    // Model input geometry (NHWC). Returns false if not ready.
+    bool input_shape(int& batch, int& height, int& width, int& channels) const;
+
+    // Output tensor access — valid until the next process() call (a pending
+    // reload is only applied by process*(), never between these accessors).
     int          output_count()                  const;
     const float* output_data(int tensor_idx = 0) const;
     int          output_size(int tensor_idx = 0) const;
 
 private:
-    Accelerator                       accel_;
-    bool                              ready_   = false;
-    std::unique_ptr<InferenceBackend> backend_;
+    std::shared_ptr<InferenceBackend> load(const std::string& model_path, std::string& name) const;
+
+    // Swap in a prepared reload (if any) and return the backend to run on.
+    std::shared_ptr<InferenceBackend> acquire();
+    std::shared_ptr<InferenceBackend> current() const { return std::atomic_load(&backend_); }
+
+    std::string                       preferred_;
+    uint32_t                          required_caps_;
+    EngineInputOptions                input_;
+    std::atomic<bool>                 ready_{false};
+    std::shared_ptr<InferenceBackend> backend_;  // accessed via atomic_load / atomic_store
+    std::vector<uint8_t>              resize_buf_;
+
+    mutable std::mutex                reload_mutex_;
+    std::thread                       reload_thread_;
+    std::string                       backend_name_;      // guarded by reload_mutex_
+    std::shared_ptr<InferenceBackend> pending_;           // guarded by reload_mutex_
+    std::string                       pending_name_;      // guarded by reload_mutex_
+    std::atomic<bool>                 pending_ready_{false};
+    std::atomic<bool>                 reloading_{false};
 };
@@ -0,0 +1,110 @@
+#include "inference_graph.h"
+#include "inference_engine.h"
+#include "roi_resize.h"
+
+#include <algorithm>
+
+static int next_pow2(int n) {
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+int InferenceGraph::add_crop_stage(const CropStageConfig& config) {
+    stages_.push_back(config);
+    stages_.back().max_batch = next_pow2(std::max(1, config.max_batch));
+    return static_cast<int>(stages_.size()) - 1;
+}
+
+bool InferenceGraph::run(const uint8_t* rgb_data, int width, int height,
+                         std::vector<CascadeDetection>& out) {
+    out.clear();
+    if (!detector_.engine || !rgb_data) return false;
+
+    // Stage 1: whole frame, resized to the detector's input if needed.
+    if (!detector_.engine->process_resized(rgb_data, width, height)) return false;
+
+    std::vector<Detection> dets = decode_ssd_detections(*detector_.engine, detector_.min_score,
+                                                        detector_.max_detections, detector_.layout);
+    ++stats_.frames;
+    stats_.detections += dets.size();
+
+    out.reserve(dets.size());
+    for (const auto& d : dets) {
+        CascadeDetection cd;
+        cd.det = d;
+        cd.stage_outputs.resize(stages_.size());
+        out.push_back(std::move(cd));
+    }
+
+    // Stage 2..N: crops. Nothing to do on empty frames.
+    bool ok = true;
+    if (!out.empty())
+        for (int i = 0; i < (int)stages_.size(); ++i)
+            ok &= run_crop_stage(i, rgb_data, width, height, out);
+    return ok;
+}
+
+bool InferenceGraph::run_crop_stage(int stage_idx, const uint8_t* rgb_data, int width, int height,
+                                    std::vector<CascadeDetection>& dets) {
+    const CropStageConfig& stage = stages_[stage_idx];
+    if (!stage.engine) return false;
+
+    int b = 0, in_h = 0, in_w = 0, in_c = 0;
+    if (!stage.engine->input_shape(b, in_h, in_w, in_c)) return false;
+    const size_t crop_bytes = static_cast<size_t>(in_w) * in_h * 3;
+
+    // Detections this stage applies to.
+    std::vector<int> selected;
+    for (int i = 0; i < (int)dets.size(); ++i) {
+        const auto& cls = stage.classes;
+        if (cls.empty() || std::find(cls.begin(), cls.end(), dets[i].det.class_id) != cls.end())
+            selected.push_back(i);
+    }
+
+    bool can_batch = true;
+    for (size_t first = 0; first < selected.size(); first += stage.max_batch) {
+        const int count  = std::min<int>(stage.max_batch, static_cast<int>(selected.size() - first));
+        const int bucket = can_batch ? next_pow2(count) : 1;
+
+        // Resize every ROI straight from the source frame into the batch.
+        crop_batch_.assign(crop_bytes * std::max(bucket, count), 0);
+        for (int k = 0; k < count; ++k) {
+            const Detection& d = dets[selected[first + k]].det;
+            const float pw = d.width()  * stage.padding;
+            const float ph = d.height() * stage.padding;
+            const int x0 = static_cast<int>((d.x0 - pw) * width);
+            const int y0 = static_cast<int>((d.y0 - ph) * height);
+            const int x1 = static_cast<int>((d.x1 + pw) * width);
+            const int y1 = static_cast<int>((d.y1 + ph) * height);
+            resize_rgb_roi(rgb_data, width, height, 0,
+                           x0, y0, x1 - x0, y1 - y0,
+                           crop_batch_.data() + crop_bytes * k, in_w, in_h);
+        }
+
+        auto collect = [&](int k, const float* data, int n) {
+            dets[selected[first + k]].stage_outputs[stage_idx].assign(data, data + n);
+        };
+
+        if (can_batch && stage.engine->process_batch(crop_batch_.data(), bucket, in_w, in_h)) {
+            ++stats_.stage_invokes;
+            const float* data = stage.engine->output_data(0);
+            const int    per  = stage.engine->output_size(0) / bucket;
+            if (!data || per <= 0) return false;
+            for (int k = 0; k < count; ++k) collect(k, data + per * k, per);
+        } else {
+            // Fixed-batch model: one invocation per crop from here on.
+            can_batch = false;
+            for (int k = 0; k < count; ++k) {
+                if (!stage.engine->process(crop_batch_.data() + crop_bytes * k, in_w, in_h))
+                    return false;
+                ++stats_.stage_invokes;
+                const float* data = stage.engine->output_data(0);
+                if (!data) return false;
+                collect(k, data, stage.engine->output_size(0));
+            }
+        }
+        stats_.crops += count;
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "detection.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class InferenceEngine;
+
+// Whole-frame first stage of a cascade (SSD-style detector).
+struct DetectorStageConfig {
+    InferenceEngine* engine         = nullptr;  // not owned
+    float            min_score      = 0.5f;
+    int              max_detections = 32;
+    SsdOutputLayout  layout;
+};
+
+// Per-detection second stage (classifier, re-id embedding, attribute model…).
+struct CropStageConfig {
+    std::string      name;
+    InferenceEngine* engine    = nullptr;  // not owned
+    float            padding   = 0.1f;     // grow each box by this fraction per side
+    int              max_batch = 16;       // largest batch bucket (power of two)
+    std::vector<int> classes;              // detector classes to crop; empty → all
+};
+
+struct CascadeDetection {
+    Detection det;
+    // Output tensor 0 of each crop stage for this detection, indexed like the
+    // stages were added. Empty when the stage skipped this detection's class.
+    std::vector<std::vector<float>> stage_outputs;
+};
+
+// Detector → per-crop cascade for one stream.
+//
+//   frame ──resize──▶ detector ──▶ boxes ──crop+resize (batched)──▶ stage 0..N
+//
+// Second-stage cost scales with the number of detections, not the frame rate:
+// all crops for a stage are resized straight from the source frame (SIMD
+// bilinear, no intermediate full-frame copy) into one NHWC batch and run in a
+// single invocation. Batch sizes are rounded up to powers of two so the
+// backend re-allocates tensors at most log2(max_batch) times; backends that
+// cannot batch fall back to one invocation per crop.
+//
+// Not thread-safe: one graph per stream (engines may be shared between graphs
+// only if the caller serialises run()).
+class InferenceGraph {
+public:
+    struct Stats {
+        uint64_t frames         = 0;
+        uint64_t detections     = 0;
+        uint64_t crops          = 0;  // crops run through any second stage
+        uint64_t stage_invokes  = 0;  // second-stage backend invocations
+    };
+
+    void set_detector(const DetectorStageConfig& config) { detector_ = config; }
+
+    // Returns the stage index used in CascadeDetection::stage_outputs.
+    int add_crop_stage(const CropStageConfig& config);
+
+    // Run the full cascade on one packed RGB frame (width × height × 3).
+    bool run(const uint8_t* rgb_data, int width, int height,
+             std::vector<CascadeDetection>& out);
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool run_crop_stage(int stage_idx, const uint8_t* rgb_data, int width, int height,
+                        std::vector<CascadeDetection>& dets);
+
+    DetectorStageConfig          detector_;
+    std::vector<CropStageConfig> stages_;
+    Stats                        stats_;
+
+    std::vector<uint8_t> crop_batch_;  // reused across frames
+};
@@ -0,0 +1,251 @@
+#include "inference_scheduler.h"
+#include "inference_engine.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+constexpr double kEmaAlpha = 0.1;
+// Under overload, a released job passed over this many times in a row runs
+// next whatever its priority: low-priority streams keep a minimum share.
+constexpr int kMaxPassedOver = 8;
+
+double ema(double prev, double sample) {
+    return prev == 0.0 ? sample : prev + kEmaAlpha * (sample - prev);
+}
+
+template <typename D>
+double seconds(D d) { return std::chrono::duration<double>(d).count(); }
+
+} // namespace
+
+InferenceScheduler::InferenceScheduler(InferenceEngine& engine) : engine_(engine) {}
+
+InferenceScheduler::~InferenceScheduler() { stop(); }
+
+InferenceScheduler::StreamState& InferenceScheduler::state_for(int slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& st = streams_[slot];
+    if (!st) {
+        st = std::make_unique<StreamState>();
+        st->release    = Clock::now();
+        st->stats.slot = slot;
+    }
+    return *st;
+}
+
+void InferenceScheduler::configure_stream(int slot, const StreamSchedule& schedule) {
+    StreamState& st = state_for(slot);
+    std::lock_guard<std::mutex> lock(st.mutex);
+    st.schedule = schedule;
+    st.release  = std::min(st.release, Clock::now());  // apply the new rate immediately
+}
+
+StreamSchedule InferenceScheduler::schedule(int slot) {
+    StreamState& st = state_for(slot);
+    std::lock_guard<std::mutex> lock(st.mutex);
+    return st.schedule;
+}
+
+void InferenceScheduler::remove_stream(int slot) {
+    StreamState* st = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = streams_.find(slot);
+        if (it == streams_.end()) return;
+        st = it->second.get();
+    }
+    std::lock_guard<std::mutex> lock(st->mutex);
+    st->schedule         = StreamSchedule{};
+    st->release          = Clock::now();
+    st->last_arrival     = Clock::time_point{};
+    st->frame_interval_s = 0.0;
+    st->last_inference   = Clock::time_point{};
+    st->passed_over      = 0;
+    st->pending          = false;
+    st->stats            = StreamStats{};
+    st->stats.slot       = slot;
+    ++st->epoch;
+}
+
+void InferenceScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    worker_  = std::thread(&InferenceScheduler::worker, this);
+}
+
+void InferenceScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+void InferenceScheduler::on_frame(const FrameMeta& meta, const uint8_t* rgb_data,
+                                  int width, int height, int stride) {
+    const auto now = Clock::now();
+    StreamState& st = state_for(meta.slot);
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        ++st.stats.frames_seen;
+        if (st.last_arrival.time_since_epoch().count() != 0)
+            st.frame_interval_s = ema(st.frame_interval_s, seconds(now - st.last_arrival));
+        st.last_arrival = now;
+
+        if (st.schedule.target_hz <= 0.0) return;  // inference disabled for this stream
+
+        // Another frame will arrive before this stream is released: skip the copy.
+        if (seconds(st.release - now) > st.frame_interval_s) {
+            ++st.stats.skipped_stale;
+            return;
+        }
+        if (st.pending) ++st.stats.skipped_stale;  // replaced before it ran
+
+        st.frame.resize(static_cast<size_t>(width) * height * 3);  // capacity reused frame to frame
+        copy_packed_rgb(st.frame.data(), rgb_data, width, height, stride);
+        st.width   = width;
+        st.height  = height;
+        st.meta    = meta;
+        st.arrival = now;
+        st.pending = true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+    }
+    cv_.notify_one();
+}
+
+void InferenceScheduler::worker() {
+    std::vector<uint8_t> work;
+
+    while (true) {
+        uint64_t gen;
+        std::vector<std::pair<int, StreamState*>> streams;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) break;
+            gen = generation_;
+            for (auto& kv : streams_) streams.emplace_back(kv.first, kv.second.get());
+        }
+
+        // Collect released jobs; note when the next one becomes eligible.
+        const auto now = Clock::now();
+        auto next_wake = now + std::chrono::milliseconds(100);
+        struct Job { StreamState* st; Clock::time_point deadline; int priority; bool missed; bool starved; };
+        std::vector<Job> jobs;
+        for (auto& [slot, st] : streams) {
+            std::lock_guard<std::mutex> lock(st->mutex);
+            if (!st->pending) continue;
+            if (st->release > now) { next_wake = std::min(next_wake, st->release); continue; }
+            // A frame that arrived after the release (slow or thinned camera,
+            // idle stream) cannot have been late before it existed.
+            const auto deadline = std::max(st->release, st->arrival) +
+                std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::milli>(st->schedule.deadline_ms));
+            jobs.push_back({st, deadline, st->schedule.priority, deadline < now,
+                            st->passed_over >= kMaxPassedOver});
+        }
+
+        if (jobs.empty()) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_until(lock, next_wake, [&] { return !running_ || generation_ != gen; });
+            continue;
+        }
+
+        // EDF while keeping up; priority first once deadlines are being
+        // missed, except for jobs starved by that for too long.
+        const bool overload = std::any_of(jobs.begin(), jobs.end(), [](const Job& j) { return j.missed; });
+        const Job& job = *std::min_element(jobs.begin(), jobs.end(), [&](const Job& a, const Job& b) {
+            if (overload && a.starved != b.starved) return a.starved;
+            if (overload && a.priority != b.priority) return a.priority > b.priority;
+            return a.deadline < b.deadline;
+        });
+        for (const Job& other : jobs) {
+            if (other.st == job.st) continue;
+            std::lock_guard<std::mutex> lock(other.st->mutex);
+            ++other.st->passed_over;
+        }
+
+        StreamState& st = *job.st;
+        int width = 0, height = 0;
+        FrameMeta meta;
+        Clock::time_point arrival;
+        uint64_t epoch;
+        {
+            std::lock_guard<std::mutex> lock(st.mutex);
+            if (!st.pending) continue;  // removed since the jobs were collected
+            epoch = st.epoch;
+            std::swap(work, st.frame);
+            width      = st.width;
+            height     = st.height;
+            meta       = st.meta;
+            arrival    = st.arrival;
+            st.pending = false;
+            st.passed_over = 0;
+
+            const auto period = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / std::max(st.schedule.target_hz, 1e-3)));
+            // Rebase so a slow or idle stream never accumulates debt.
+            if (job.missed) {
+                ++st.stats.deadline_misses;
+                st.release = now + period;
+            } else {
+                st.release = std::max(st.release + period, now);
+            }
+        }
+
+        const bool ok = engine_.process_resized(work.data(), width, height);
+        bool current;
+        {
+            std::lock_guard<std::mutex> lock(st.mutex);
+            current = st.epoch == epoch;
+        }
+        if (ok && current && callback_) callback_(meta, engine_);
+
+        const auto done = Clock::now();
+        std::lock_guard<std::mutex> lock(st.mutex);
+        if (ok && st.epoch == epoch) {
+            ++st.stats.inferences;
+            st.stats.latency_ms = ema(st.stats.latency_ms, seconds(done - arrival) * 1000.0);
+            if (st.last_inference.time_since_epoch().count() != 0)
+                st.stats.achieved_hz = ema(st.stats.achieved_hz,
+                                           1.0 / std::max(seconds(done - st.last_inference), 1e-6));
+            st.last_inference = done;
+        }
+        // Hand the buffer back so the mailbox keeps its allocation.
+        if (!st.pending) std::swap(work, st.frame);
+    }
+}
+
+std::vector<InferenceScheduler::StreamStats> InferenceScheduler::stats() const {
+    std::vector<StreamState*> streams;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& kv : streams_) streams.push_back(kv.second.get());
+    }
+    std::vector<StreamStats> out;
+    for (StreamState* st : streams) {
+        std::lock_guard<std::mutex> lock(st->mutex);
+        out.push_back(st->stats);
+    }
+    return out;
+}
+
+void InferenceScheduler::print_stats() const {
+    std::cout << "\n=== Inference Scheduler ===" << std::endl;
+    for (const auto& s : stats()) {
+        std::cout << "[slot " << s.slot << "] "
+                  << std::fixed << std::setprecision(1)
+                  << s.achieved_hz << " Hz, latency " << s.latency_ms << " ms, "
+                  << s.inferences << "/" << s.frames_seen << " frames inferred, "
+                  << s.skipped_stale << " stale, "
+                  << s.deadline_misses << " deadline misses" << std::endl;
+    }
+}
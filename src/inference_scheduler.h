@@ -0,0 +1,116 @@
+#pragma once
+
+#include "frame_consumer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class InferenceEngine;
+
+// Per-stream scheduling contract.
+struct StreamSchedule {
+    int    priority    = 0;      // higher wins when the budget is exceeded
+    double target_hz   = 5.0;    // desired inference rate; ≤ 0 disables the stream
+    double deadline_ms = 200.0;  // max delay from release (or a later arrival) to inference start
+};
+
+// Latency-budget scheduler in front of a single InferenceEngine.
+//
+// Each stream owns a one-frame mailbox: a newer frame always replaces an
+// unprocessed older one (skip-stale), so queues never build up and inference
+// always runs on the newest frame. A stream's job is released every
+// 1 / target_hz; among released jobs the worker runs earliest-deadline-first.
+// A deadline runs from the later of release and frame arrival, so streams
+// slower than their target rate are not counted late. Once deadlines are being
+// missed (overload) higher-priority streams go first, and a stream that missed
+// its deadline is re-released from "now"; releases never fall behind the
+// clock, so an idle stream does not return with a burst of owed jobs —
+// low-priority cameras degrade gracefully to lower rates, but a job passed
+// over several times in a row still gets its turn, so none starves.
+//
+// Frames arriving well before their stream's next release are dropped without
+// copying, so the per-frame cost on streaming threads is one clock read.
+class InferenceScheduler : public FrameConsumer {
+public:
+    struct StreamStats {
+        int      slot            = 0;
+        double   achieved_hz     = 0.0;  // EMA of inference rate
+        double   latency_ms      = 0.0;  // EMA of frame arrival → inference done
+        uint64_t frames_seen     = 0;
+        uint64_t inferences      = 0;
+        uint64_t skipped_stale   = 0;    // frames replaced or dropped before inference
+        uint64_t deadline_misses = 0;
+    };
+
+    // Called on the worker thread after each inference; engine outputs are
+    // valid for the duration of the call. `frame` identifies the exact frame
+    // that was inferred (not the newest one), e.g. for a ResultTimeline.
+    using ResultCallback = std::function<void(const FrameMeta& frame, const InferenceEngine& engine)>;
+
+    explicit InferenceScheduler(InferenceEngine& engine);
+    ~InferenceScheduler() override;
+
+    // May be called at any time; unknown slots get the default schedule.
+    void configure_stream(int slot, const StreamSchedule& schedule);
+    StreamSchedule schedule(int slot);
+    // Forget a removed stream: its pending frame is dropped, an inference
+    // already running for it publishes no result, and schedule and stats
+    // start from defaults for whatever stream is added to the slot next.
+    void remove_stream(int slot);
+    void set_result_callback(ResultCallback cb) { callback_ = std::move(cb); }
+
+    void start();
+    void stop();
+
+    // FrameConsumer: called from streaming threads.
+    void on_frame(const FrameMeta& meta, const uint8_t* rgb_data,
+                  int width, int height, int stride) override;
+
+    std::vector<StreamStats> stats() const;
+    void print_stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Everything below is guarded by StreamState::mutex; mutex_ only guards
+    // the map itself and the wake-up generation counter.
+    struct StreamState {
+        std::mutex           mutex;
+        StreamSchedule       schedule;
+        Clock::time_point    release;           // next time a job may start
+        Clock::time_point    last_arrival;
+        double               frame_interval_s = 0.0;  // EMA of arrival spacing
+        Clock::time_point    last_inference;
+        int                  passed_over = 0;   // released, pending and not picked
+        uint64_t             epoch       = 0;   // bumped by remove_stream()
+
+        bool                 pending = false;
+        std::vector<uint8_t> frame;             // mailbox (newest frame)
+        int                  width  = 0;
+        int                  height = 0;
+        FrameMeta            meta;
+        Clock::time_point    arrival;
+
+        StreamStats          stats;
+    };
+
+    StreamState& state_for(int slot);
+    void worker();
+
+    InferenceEngine& engine_;
+    ResultCallback   callback_;
+
+    mutable std::mutex      mutex_;
+    std::condition_variable cv_;
+    std::map<int, std::unique_ptr<StreamState>> streams_;  // never erased: pointers stay valid
+    uint64_t                generation_ = 0;  // bumped on every new mailbox frame
+    bool                    running_    = false;
+    std::thread             worker_;
+};
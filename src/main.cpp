@@ -1,39 +1,114 @@
 #include <gst/gst.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
+#include "app_config.h"
+#include "control_server.h"
+#include "detection.h"
+#include "detection_ring.h"
+#include "frame_export.h"
+#include "inference_engine.h"
+#include "inference_scheduler.h"
+#include "quality_controller.h"
+#include "result_timeline.h"
 #include "rtsp_stream_manager.h"
 #include "video_renderer.h"
 
+// Headless runs have no window to close; SIGINT/SIGTERM end the loop instead.
+static std::atomic<bool> g_quit{false};
+
+static void on_quit_signal(int) { g_quit = true; }
+
 static void usage(const char* prog) {
     std::cerr
         << "Usage:\n"
         << "  " << prog << " <root_url> <endpoint1> [endpoint2 ...]\n"
         << "  " << prog << " --debug <root_url> <endpoint> <repeat_count>\n"
+        << "  " << prog << " --replay <file.mp4|file.mkv|capture.pcap> <repeat_count> [--fast] [--loop]\n"
+        << "  " << prog << " --config <deployment.json>\n"
+        << "\n"
+        << "Any mode accepts --headless: no window or GL context; frames go to the\n"
+        << "  inference and export consumers only, pulled by one thread per stream.\n"
         << "\n"
         << "Normal mode: connects to root_url + each endpoint simultaneously.\n"
         << "  Example: " << prog << " rtsp://192.168.1.100:554 /ch0 /ch1 /ch2\n"
         << "\n"
         << "Debug mode: spawns repeat_count independent pipelines for one endpoint\n"
         << "  to stress-test hardware codec throughput.\n"
-        << "  Example: " << prog << " --debug rtsp://192.168.1.100:554 /ch0 4\n";
+        << "  Example: " << prog << " --debug rtsp://192.168.1.100:554 /ch0 4\n"
+        << "\n"
+        << "Replay mode: decodes a local recording repeat_count times for reproducible\n"
+        << "  offline measurements. --fast disables real-time pacing, --loop restarts at EOS.\n"
+        << "  Example: " << prog << " --replay clip.mp4 4 --fast\n"
+        << "\n"
+        << "Config mode: streams, per-stream transport/latency/decode and inference\n"
+        << "  rates, layout, model and exports from a JSON file (see app_config.h).\n";
 }
 
 int main(int argc, char* argv[]) {
     gst_init(&argc, &argv);
 
+    // --headless may appear anywhere; strip it so the modes below see
+    // their usual positional arguments.
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) != "--headless") continue;
+        headless = true;
+        for (int j = i; j < argc - 1; ++j) argv[j] = argv[j + 1];
+        --argc;
+        break;
+    }
+
     if (argc < 3) {
         usage(argv[0]);
         return 1;
     }
 
-    bool debug_mode = (std::string(argv[1]) == "--debug");
+    bool debug_mode  = (std::string(argv[1]) == "--debug");
+    bool replay_mode = (std::string(argv[1]) == "--replay");
+    bool config_mode = (std::string(argv[1]) == "--config");
 
-    std::string              root_url;
-    std::vector<std::string> full_urls;
+    std::string               root_url;
+    std::vector<std::string>  full_urls;
+    std::vector<StreamSource> sources;
+    AppConfig                 config;
+
+    if (config_mode) {
+        // --config <file>
+        if (argc != 3) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (!load_app_config(argv[2], config)) return 1;
+        headless = headless || config.headless;
+    } else if (replay_mode) {
+        // --replay <file> <repeat_count> [--fast] [--loop]
+        StreamSource src = StreamSource::from_url(argv[2]);
+        int count = (argc > 3) ? std::atoi(argv[3]) : 0;
+        if (src.kind == SourceKind::Rtsp || count < 1) {
+            usage(argv[0]);
+            return 1;
+        }
+        for (int i = 4; i < argc; ++i) {
+            std::string opt = argv[i];
+            if      (opt == "--fast") src.pacing = ReplayPacing::AsFastAsPossible;
+            else if (opt == "--loop") src.loop   = true;
+            else { usage(argv[0]); return 1; }
+        }
+        for (int i = 0; i < count; ++i)
+            sources.push_back(src);
 
-    if (debug_mode) {
+        std::cout << "Replay mode: " << count << " pipeline(s) → " << src.location
+                  << (src.pacing == ReplayPacing::AsFastAsPossible ? " (as fast as possible)" : " (real time)")
+                  << "\n";
+    } else if (debug_mode) {
         // --debug <root_url> <endpoint> <repeat_count>
         if (argc != 5) {
             usage(argv[0]);
@@ -58,23 +133,122 @@ int main(int argc, char* argv[]) {
             full_urls.push_back(root_url + std::string(argv[i]));
     }
 
-    int num_streams = (int)full_urls.size();
+    for (const auto& url : full_urls)
+        sources.push_back(StreamSource::from_url(url));
+    for (const auto& src : sources)
+        config.streams.push_back({src, StreamSchedule{}});
+
+    int num_streams = (int)config.streams.size();
     std::cout << "Starting " << num_streams << " stream(s)\n";
 
-    VideoRenderer    renderer(num_streams, "RTSP Stream");
-    RtspStreamManager manager;
-    manager.set_renderer(&renderer);
+    const LayoutConfig& layout = config.layout;
+    const int           slots  = std::max(num_streams, layout.slots);
+    std::unique_ptr<VideoRenderer> renderer;
+    RtspStreamManager              manager;
+    // A shared pull pool keeps consumer work off the decode threads and
+    // bounds the thread count however many streams there are.
+    if (config.consumer_threads > 0)
+        manager.set_delivery(SampleDelivery::Pool, config.consumer_threads);
+    if (headless) {
+        // No GLFW: decoded frames only feed consumers, pulled off the
+        // appsinks by per-stream worker threads unless a pool is configured.
+        if (config.consumer_threads == 0) manager.set_delivery(SampleDelivery::Pull);
+        std::signal(SIGINT, on_quit_signal);
+        std::signal(SIGTERM, on_quit_signal);
+        std::cout << "Headless mode: no renderer\n";
+    } else {
+        renderer = layout.windows.empty()
+            ? std::make_unique<VideoRenderer>(slots, layout.title, layout.columns,
+                                              layout.window_width, layout.window_height)
+            : std::make_unique<VideoRenderer>(slots, layout.windows);
+        // Rendering runs on its own thread from here on (GStreamer GL wraps
+        // the context there too); GLFW events must stay on this one.
+        renderer->start_render_thread();
+        renderer->set_present_latency_ms(layout.present_latency_ms);
+        renderer->set_upload_budget(layout.upload_budget_ms, layout.upload_budget_mb);
+        manager.set_renderer(renderer.get());
+    }
+    manager.set_slot_capacity(slots);
 
-    for (const auto& url : full_urls)
-        manager.add_stream(url);
+    // Optional inference and exports (config mode only). Declared before the
+    // streams start so they outlive every streaming-thread callback.
+    std::unique_ptr<InferenceEngine>    engine;
+    std::unique_ptr<InferenceScheduler> scheduler;
+    ResultTimeline                      timeline;
+    DetectionRing                       detection_ring;
+    FrameExport                         frame_export;
+
+    const bool export_detections = config.exports.detections &&
+                                   detection_ring.create(config.exports.detection_capacity);
+    if (config.exports.frames &&
+        frame_export.create(config.exports.frame_slots, config.exports.frame_max_width,
+                            config.exports.frame_max_height))
+        manager.add_consumer(&frame_export);
+
+    if (!config.model.path.empty()) {
+        engine = std::make_unique<InferenceEngine>(config.model.path, config.model.backend, 0,
+                                                   config.model.input);
+        if (!engine->ready()) return 1;
+        scheduler = std::make_unique<InferenceScheduler>(*engine);
+        for (int i = 0; i < num_streams; ++i)
+            scheduler->configure_stream(i, config.streams[i].schedule);
 
-    // Render loop on the main thread (required by GLFW)
-    while (!renderer.should_close())  {
-        renderer.render();
-        renderer.poll_events();
+        const ModelConfig model = config.model;
+        scheduler->set_result_callback([&, model](const FrameMeta& frame, const InferenceEngine& e) {
+            auto dets = decode_ssd_detections(e, model.min_score, model.max_detections);
+            if (export_detections) detection_ring.publish(frame, dets);
+            timeline.record(frame, std::move(dets));
+        });
+        scheduler->start();
+        manager.add_consumer(scheduler.get());
     }
 
+    ControlServer control({&manager, renderer.get(), scheduler.get(), engine.get(),
+                           scheduler ? &timeline : nullptr});
+    if (!config.control.socket.empty() && !control.start(config.control.socket)) return 1;
+
+    for (const auto& sc : config.streams)
+        manager.add_stream(sc.source);
+
+    std::unique_ptr<QualityController> quality;
+    if (config.quality.enabled)
+        quality = std::make_unique<QualityController>(manager, scheduler.get(), renderer.get(),
+                                                      config.quality.targets);
+
+    auto t_start = std::chrono::steady_clock::now();
+
+    if (renderer) {
+        while (!renderer->should_close())  {
+            control.apply_pending();  // runtime changes land between frames
+            if (quality) quality->update();
+            renderer->wait_events(0.01);  // input, or at least every 10 ms for control requests
+            if (replay_mode && manager.all_finished()) break;
+        }
+        renderer->stop_render_thread();
+    } else {
+        // Headless: the main thread only services control requests.
+        while (!g_quit) {
+            control.apply_pending();
+            if (quality) quality->update();
+            if (replay_mode && manager.all_finished()) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    if (replay_mode) {
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+        for (const auto& s : manager.streams())
+            std::cout << "[slot " << s->get_slot() << "] " << s->frames_received() << " frames, "
+                      << (secs > 0 ? s->frames_received() / secs : 0.0) << " fps\n";
+    }
+
+    control.stop();
     manager.stop_all_streams();
+    if (scheduler) {
+        scheduler->stop();
+        scheduler->print_stats();
+    }
+    renderer.reset();  // may still hold decoded buffers
     gst_deinit();
     return 0;
 }
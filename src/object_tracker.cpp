@@ -0,0 +1,298 @@
+#include "object_tracker.h"
+#include "inference_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ---------------------------------------------------------------------------
+// Kalman filter (constant velocity over cx, cy, area, aspect)
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int N = 7;  // state size
+constexpr int M = 4;  // measurement size
+
+// Relative noise weights per state component. Positions live in [0, 1],
+// areas are roughly 100× smaller and aspect ratios roughly 10× larger.
+constexpr float kQWeights[N] = {1.f, 1.f, 0.1f, 1.f, 0.25f, 0.25f, 0.01f};
+constexpr float kRWeights[M] = {1.f, 1.f, 0.1f, 100.f};
+constexpr float kInitVelocityVar = 1e-2f;  // ±0.1 frame widths per frame
+constexpr float kInitAreaVelVar  = 1e-4f;
+
+void measurement(const Detection& d, float z[M]) {
+    const float w = std::max(d.width(),  1e-6f);
+    const float h = std::max(d.height(), 1e-6f);
+    z[0] = d.x0 + w * 0.5f;
+    z[1] = d.y0 + h * 0.5f;
+    z[2] = w * h;
+    z[3] = w / h;
+}
+
+// In-place Gauss-Jordan inverse of a 4×4 matrix. Returns false if singular.
+bool invert4(float a[M * M]) {
+    float inv[M * M] = {};
+    for (int i = 0; i < M; ++i) inv[i * M + i] = 1.f;
+    for (int c = 0; c < M; ++c) {
+        int pivot = c;
+        for (int r = c + 1; r < M; ++r)
+            if (std::fabs(a[r * M + c]) > std::fabs(a[pivot * M + c])) pivot = r;
+        if (std::fabs(a[pivot * M + c]) < 1e-12f) return false;
+        if (pivot != c)
+            for (int k = 0; k < M; ++k) {
+                std::swap(a[c * M + k],   a[pivot * M + k]);
+                std::swap(inv[c * M + k], inv[pivot * M + k]);
+            }
+        const float d = 1.f / a[c * M + c];
+        for (int k = 0; k < M; ++k) { a[c * M + k] *= d; inv[c * M + k] *= d; }
+        for (int r = 0; r < M; ++r) {
+            if (r == c) continue;
+            const float f = a[r * M + c];
+            for (int k = 0; k < M; ++k) {
+                a[r * M + k]   -= f * a[c * M + k];
+                inv[r * M + k] -= f * inv[c * M + k];
+            }
+        }
+    }
+    std::copy(inv, inv + M * M, a);
+    return true;
+}
+
+} // namespace
+
+void ObjectTracker::init_filter(Filter& f, const Detection& d) const {
+    float z[M];
+    measurement(d, z);
+    f.x = {z[0], z[1], z[2], z[3], 0.f, 0.f, 0.f};
+    f.P.fill(0.f);
+    for (int i = 0; i < M; ++i) f.P[i * N + i] = 10.f * config_.measurement_noise * kRWeights[i];
+    f.P[4 * N + 4] = kInitVelocityVar;
+    f.P[5 * N + 5] = kInitVelocityVar;
+    f.P[6 * N + 6] = kInitAreaVelVar;
+}
+
+void ObjectTracker::predict_filter(Filter& f) const {
+    if (f.x[2] + f.x[6] <= 0.f) f.x[6] = 0.f;  // never predict a negative area
+    f.x[0] += f.x[4];
+    f.x[1] += f.x[5];
+    f.x[2] += f.x[6];
+
+    // P = F P Fᵀ + Q with F = I + (rows 0..2 pick up velocities 4..6).
+    std::array<float, 49> FP = f.P;
+    for (int i = 0; i < 3; ++i)
+        for (int k = 0; k < N; ++k) FP[i * N + k] += f.P[(i + 4) * N + k];
+    std::array<float, 49> P = FP;
+    for (int r = 0; r < N; ++r)
+        for (int i = 0; i < 3; ++i) P[r * N + i] += FP[r * N + i + 4];
+    for (int i = 0; i < N; ++i) P[i * N + i] += config_.process_noise * kQWeights[i];
+    f.P = P;
+}
+
+void ObjectTracker::correct_filter(Filter& f, const Detection& d) const {
+    float z[M];
+    measurement(d, z);
+
+    // H picks the first four state components, so H P Hᵀ and P Hᵀ are slices.
+    float S[M * M];
+    for (int r = 0; r < M; ++r)
+        for (int c = 0; c < M; ++c) S[r * M + c] = f.P[r * N + c];
+    for (int i = 0; i < M; ++i) S[i * M + i] += config_.measurement_noise * kRWeights[i];
+    if (!invert4(S)) return;
+
+    float K[N * M] = {};
+    for (int r = 0; r < N; ++r)
+        for (int c = 0; c < M; ++c)
+            for (int k = 0; k < M; ++k) K[r * M + c] += f.P[r * N + k] * S[k * M + c];
+
+    float y[M];
+    for (int i = 0; i < M; ++i) y[i] = z[i] - f.x[i];
+    for (int r = 0; r < N; ++r)
+        for (int k = 0; k < M; ++k) f.x[r] += K[r * M + k] * y[k];
+
+    // P = P − K (H P)
+    std::array<float, 49> P = f.P;
+    for (int r = 0; r < N; ++r)
+        for (int c = 0; c < N; ++c)
+            for (int k = 0; k < M; ++k) P[r * N + c] -= K[r * M + k] * f.P[k * N + c];
+    f.P = P;
+}
+
+void ObjectTracker::write_box(const Filter& f, Track& t) {
+    const float s = std::max(f.x[2], 1e-8f);
+    const float r = std::max(f.x[3], 1e-4f);
+    const float w = std::sqrt(s * r);
+    const float h = s / w;
+    t.box.x0 = f.x[0] - w * 0.5f;
+    t.box.x1 = f.x[0] + w * 0.5f;
+    t.box.y0 = f.x[1] - h * 0.5f;
+    t.box.y1 = f.x[1] + h * 0.5f;
+    t.uncertainty = std::sqrt(std::max(0.f, f.P[0] + f.P[N + 1]));
+}
+
+// ---------------------------------------------------------------------------
+// Hungarian assignment (Kuhn–Munkres with potentials, O(n² m))
+// ---------------------------------------------------------------------------
+
+std::vector<int> hungarian_assign(const std::vector<std::vector<float>>& cost) {
+    const int rows = static_cast<int>(cost.size());
+    const int cols = rows ? static_cast<int>(cost[0].size()) : 0;
+    std::vector<int> result(rows, -1);
+    if (rows == 0 || cols == 0) return result;
+
+    // The algorithm needs n ≤ m; solve the transpose otherwise.
+    const bool transposed = rows > cols;
+    const int  n = transposed ? cols : rows;
+    const int  m = transposed ? rows : cols;
+    auto a = [&](int i, int j) -> double {
+        return transposed ? cost[j - 1][i - 1] : cost[i - 1][j - 1];
+    };
+
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0);
+    std::vector<int>    p(m + 1, 0), way(m + 1, 0);
+
+    for (int i = 1; i <= n; ++i) {
+        p[0] = i;
+        int j0 = 0;
+        std::vector<double> minv(m + 1, inf);
+        std::vector<char>   used(m + 1, 0);
+        do {
+            used[j0] = 1;
+            const int i0 = p[j0];
+            double delta = inf;
+            int    j1    = 0;
+            for (int j = 1; j <= m; ++j) {
+                if (used[j]) continue;
+                const double cur = a(i0, j) - u[i0] - v[j];
+                if (cur < minv[j]) { minv[j] = cur; way[j] = j0; }
+                if (minv[j] < delta) { delta = minv[j]; j1 = j; }
+            }
+            for (int j = 0; j <= m; ++j) {
+                if (used[j]) { u[p[j]] += delta; v[j] -= delta; }
+                else         { minv[j] -= delta; }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        do {
+            const int j1 = way[j0];
+            p[j0] = p[j1];
+            j0    = j1;
+        } while (j0);
+    }
+
+    for (int j = 1; j <= m; ++j) {
+        if (!p[j]) continue;
+        if (transposed) result[j - 1]    = p[j] - 1;
+        else            result[p[j] - 1] = j - 1;
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// ObjectTracker
+// ---------------------------------------------------------------------------
+
+ObjectTracker::ObjectTracker(const TrackerConfig& config) : config_(config) {}
+
+void ObjectTracker::predict() {
+    for (size_t i = 0; i < tracks_.size(); ++i) {
+        predict_filter(filters_[i]);
+        ++tracks_[i].age;
+        ++tracks_[i].time_since_update;
+        write_box(filters_[i], tracks_[i]);
+    }
+
+    // Drop tracks that coasted too long.
+    size_t keep = 0;
+    for (size_t i = 0; i < tracks_.size(); ++i) {
+        if (tracks_[i].time_since_update > config_.max_age) continue;
+        tracks_[keep]  = tracks_[i];
+        filters_[keep] = filters_[i];
+        ++keep;
+    }
+    tracks_.resize(keep);
+    filters_.resize(keep);
+
+    ++frames_since_detect_;
+}
+
+void ObjectTracker::update(const std::vector<Detection>& detections) {
+    frames_since_detect_ = 0;
+    ever_detected_       = true;
+
+    std::vector<char> det_used(detections.size(), 0);
+    if (!tracks_.empty() && !detections.empty()) {
+        std::vector<std::vector<float>> cost(tracks_.size(),
+                                             std::vector<float>(detections.size()));
+        for (size_t t = 0; t < tracks_.size(); ++t)
+            for (size_t d = 0; d < detections.size(); ++d)
+                cost[t][d] = 1.f - iou(tracks_[t].box, detections[d]);
+
+        const std::vector<int> match = hungarian_assign(cost);
+        for (size_t t = 0; t < tracks_.size(); ++t) {
+            const int d = match[t];
+            if (d < 0 || 1.f - cost[t][d] < config_.iou_threshold) continue;
+            correct_filter(filters_[t], detections[d]);
+            Track& tr = tracks_[t];
+            ++tr.hits;
+            tr.time_since_update = 0;
+            tr.box.score    = detections[d].score;
+            tr.box.class_id = detections[d].class_id;
+            write_box(filters_[t], tr);
+            det_used[d] = 1;
+        }
+    }
+
+    // Unmatched detections start new tracks.
+    for (size_t d = 0; d < detections.size(); ++d) {
+        if (det_used[d]) continue;
+        Filter f;
+        init_filter(f, detections[d]);
+        Track t;
+        t.id   = next_id_++;
+        t.hits = 1;
+        t.box  = detections[d];
+        write_box(f, t);
+        tracks_.push_back(t);
+        filters_.push_back(f);
+    }
+}
+
+bool ObjectTracker::needs_detection() const {
+    if (!ever_detected_) return true;
+    if (frames_since_detect_ >= config_.detect_interval) return true;
+    for (const auto& t : tracks_)
+        if (t.uncertainty > config_.max_uncertainty) return true;
+    return false;
+}
+
+std::vector<Track> ObjectTracker::confirmed_tracks() const {
+    std::vector<Track> out;
+    for (const auto& t : tracks_)
+        if (t.hits >= config_.min_hits) out.push_back(t);
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// TrackedDetector
+// ---------------------------------------------------------------------------
+
+TrackedDetector::TrackedDetector(InferenceEngine& engine, const TrackerConfig& config,
+                                 float min_score, const SsdOutputLayout& layout)
+    : engine_(engine), tracker_(config), min_score_(min_score), layout_(layout) {}
+
+const std::vector<Track>& TrackedDetector::on_frame(const uint8_t* rgb_data, int width, int height) {
+    ++stats_.frames;
+    tracker_.predict();
+
+    last_inferred_ = false;
+    if (!tracker_.needs_detection()) return tracker_.tracks();
+
+    if (engine_.process_resized(rgb_data, width, height)) {
+        tracker_.update(decode_ssd_detections(engine_, min_score_, 64, layout_));
+        ++stats_.inferences;
+        last_inferred_ = true;
+    }
+    return tracker_.tracks();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "detection.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class InferenceEngine;
+
+struct TrackerConfig {
+    float iou_threshold     = 0.3f;   // minimum IoU for a detection ↔ track match
+    int   max_age           = 30;     // frames a track may coast without a match
+    int   min_hits          = 3;      // matches before a track is reported as confirmed
+    int   detect_interval   = 5;      // K: run the detector at least every K frames
+    float max_uncertainty   = 0.05f;  // position std-dev (normalized) forcing a detection
+    float process_noise     = 1e-5f;  // Kalman Q scale (per frame)
+    float measurement_noise = 1e-4f;  // Kalman R scale
+};
+
+struct Track {
+    int       id                = 0;
+    Detection box;                     // current estimate (class/score from last match)
+    int       hits              = 0;   // total detector matches
+    int       age               = 0;   // frames since creation
+    int       time_since_update = 0;   // frames since last match
+    float     uncertainty       = 0.f; // position std-dev, normalized units
+
+    bool confirmed(int min_hits) const { return hits >= min_hits && time_since_update == 0; }
+};
+
+// SORT-style multi-object tracker: constant-velocity Kalman filter per track
+// over (cx, cy, area, aspect), Hungarian assignment on 1 − IoU.
+//
+// Call predict() every frame; call update() on frames where the detector ran.
+// Between detections tracks coast on their velocity estimate, which gives
+// smooth per-frame boxes while inference runs at a fraction of the frame rate.
+class ObjectTracker {
+public:
+    explicit ObjectTracker(const TrackerConfig& config = {});
+
+    void predict();
+    void update(const std::vector<Detection>& detections);
+
+    // True when the next frame should be run through the detector: the
+    // detect interval elapsed, or some live track became too uncertain.
+    bool needs_detection() const;
+
+    const std::vector<Track>& tracks() const { return tracks_; }
+    std::vector<Track>        confirmed_tracks() const;
+    const TrackerConfig&      config() const { return config_; }
+
+private:
+    struct Filter {
+        std::array<float, 7>  x{};  // cx, cy, s, r, vcx, vcy, vs
+        std::array<float, 49> P{};  // row-major 7×7 covariance
+    };
+
+    void init_filter(Filter& f, const Detection& d) const;
+    void predict_filter(Filter& f) const;
+    void correct_filter(Filter& f, const Detection& d) const;
+    static void write_box(const Filter& f, Track& t);
+
+    TrackerConfig       config_;
+    std::vector<Track>  tracks_;
+    std::vector<Filter> filters_;  // parallel to tracks_
+    int                 next_id_              = 1;
+    int                 frames_since_detect_  = 0;
+    bool                ever_detected_        = false;
+};
+
+// Solve the rectangular assignment problem (rows → columns) minimising total
+// cost. Returns, for each row, the assigned column or −1.
+std::vector<int> hungarian_assign(const std::vector<std::vector<float>>& cost);
+
+// Per-stream detector + tracker. Feed every decoded frame; the engine is only
+// invoked when the tracker asks for it, tracks are returned for every frame.
+class TrackedDetector {
+public:
+    struct Stats {
+        uint64_t frames     = 0;
+        uint64_t inferences = 0;
+    };
+
+    TrackedDetector(InferenceEngine& engine, const TrackerConfig& config = {},
+                    float min_score = 0.5f, const SsdOutputLayout& layout = {});
+
+    // rgb_data: width × height × 3 bytes, row-major uint8.
+    const std::vector<Track>& on_frame(const uint8_t* rgb_data, int width, int height);
+
+    bool                      last_frame_inferred() const { return last_inferred_; }
+    const ObjectTracker&      tracker() const { return tracker_; }
+    const Stats&              stats() const { return stats_; }
+
+private:
+    InferenceEngine& engine_;
+    ObjectTracker    tracker_;
+    float            min_score_;
+    SsdOutputLayout  layout_;
+    Stats            stats_;
+    bool             last_inferred_ = false;
+};
@@ -0,0 +1,228 @@
+#include "quality_controller.h"
+#include "inference_scheduler.h"
+#include "rtsp_stream_manager.h"
+#include "video_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <tuple>
+
+static const char* step_name(int step) {
+    static const char* const kNames[] = {"inference rate halved", "frame rate capped",
+                                         "output downscaled", "keyframes only"};
+    return kNames[step];
+}
+
+QualityController::QualityController(RtspStreamManager& manager, InferenceScheduler* scheduler,
+                                     const VideoRenderer* renderer, const QualityTargets& targets)
+    : manager_(manager), scheduler_(scheduler), renderer_(renderer), targets_(targets),
+      window_start_(Clock::now()) {}
+
+// ---------------------------------------------------------------------------
+// Evaluation
+// ---------------------------------------------------------------------------
+
+void QualityController::update() {
+    const auto   now       = Clock::now();
+    const double window_ms = std::chrono::duration<double, std::milli>(now - window_start_).count();
+    if (window_ms < targets_.interval_ms) return;
+
+    // Forget removed or replaced streams. Only the inference rate is keyed
+    // by slot and outlives its stream; hand it back.
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        const RtspStream* current = manager_.find_stream(it->first);
+        if (current && current->id() == it->second.stream_id) {
+            ++it;
+            continue;
+        }
+        auto& applied = it->second.applied;
+        if (std::find(applied.begin(), applied.end(), Step::InferenceRate) != applied.end())
+            undo(it->first, it->second, Step::InferenceRate);
+        it = streams_.erase(it);
+    }
+
+    const double period_ms = renderer_ ? renderer_->frame_period_ms() : 0.0;
+    double lag_ms = 0.0;
+    for (const auto& s : manager_.streams()) lag_ms = std::max(lag_ms, s->decode_lag_ms());
+    const double misses = miss_ratio(window_ms / 1000.0);
+    window_start_ = now;
+
+    if (overloaded(period_ms, lag_ms, misses)) {
+        headroom_windows_ = 0;
+        if (exhausted_windows_ > 0 && ++exhausted_windows_ > kProbeWindows) {
+            // Degrading has nothing left to offer; check that restoring
+            // really is out of reach rather than trusting the metric forever.
+            std::cout << "[QualityController] Still overloaded at full degradation; probing a restore\n";
+            restore();
+            exhausted_windows_ = 0;
+        } else if (++overloaded_windows_ >= targets_.degrade_after) {
+            std::cout << "[QualityController] Overload: render " << period_ms << " ms, decode lag "
+                      << lag_ms << " ms, inference misses " << misses << "\n";
+            if (!degrade() && exhausted_windows_ == 0) exhausted_windows_ = 1;
+            overloaded_windows_ = 0;
+        }
+    } else if (has_headroom(period_ms, lag_ms, misses)) {
+        overloaded_windows_ = 0;
+        exhausted_windows_  = 0;
+        if (++headroom_windows_ >= targets_.restore_after) {
+            restore();
+            headroom_windows_ = 0;
+        }
+    } else {
+        overloaded_windows_ = 0;
+        headroom_windows_   = 0;
+        exhausted_windows_  = 0;
+    }
+}
+
+// Deadline misses per inference over the window. A stream whose frames
+// arrive slower than its inference rate (slow camera, or throttled by a
+// degradation step) is input-limited: its misses say nothing about load.
+double QualityController::miss_ratio(double window_s) {
+    if (!scheduler_) return 0.0;
+    uint64_t misses = 0, inferences = 0;
+    for (const auto& st : scheduler_->stats()) {
+        InferenceCounters& last = last_counters_[st.slot];
+        const uint64_t frames   = st.frames_seen - last.frames;
+        const double   hz       = scheduler_->schedule(st.slot).target_hz;
+        if (hz > 0.0 && frames >= hz * window_s) {
+            misses     += st.deadline_misses - last.misses;
+            inferences += st.inferences - last.inferences;
+        }
+        last = {st.deadline_misses, st.inferences, st.frames_seen};
+    }
+    return static_cast<double>(misses) / static_cast<double>(std::max<uint64_t>(1, inferences));
+}
+
+bool QualityController::overloaded(double period_ms, double lag_ms, double miss_ratio) const {
+    return period_ms  > targets_.render_period_ms ||
+           lag_ms     > targets_.decode_lag_ms ||
+           miss_ratio > targets_.inference_miss_ratio;
+}
+
+bool QualityController::has_headroom(double period_ms, double lag_ms, double miss_ratio) const {
+    const double h = targets_.headroom;
+    return period_ms  < h * targets_.render_period_ms &&
+           lag_ms     < h * targets_.decode_lag_ms &&
+           miss_ratio < h * targets_.inference_miss_ratio;
+}
+
+int QualityController::priority(int slot) const {
+    return scheduler_ ? scheduler_->schedule(slot).priority : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Ladder
+// ---------------------------------------------------------------------------
+
+bool QualityController::degrade() {
+    // Lowest priority first; among equals the least degraded, so they take turns.
+    std::vector<std::tuple<int, size_t, int>> order;  // priority, steps applied, -slot
+    for (const auto& s : manager_.streams()) {
+        StreamState& st = streams_[s->get_slot()];
+        if (!st.stream) {
+            st.stream    = s.get();
+            st.stream_id = s->id();
+        }
+        order.emplace_back(priority(s->get_slot()), st.applied.size(), -s->get_slot());
+    }
+    std::sort(order.begin(), order.end());
+
+    for (const auto& entry : order) {
+        const int    slot = -std::get<2>(entry);
+        StreamState& st   = streams_[slot];
+        for (int step = st.next_step; step < static_cast<int>(Step::Count); ++step) {
+            if (!apply(slot, st, static_cast<Step>(step))) continue;
+            st.applied.push_back(static_cast<Step>(step));
+            st.next_step = step + 1;
+            std::cout << "[QualityController] slot " << slot << ": " << step_name(step) << "\n";
+            return true;
+        }
+        st.next_step = static_cast<int>(Step::Count);  // nothing left for this stream
+    }
+    return false;
+}
+
+void QualityController::restore() {
+    // Reverse order: highest priority first, most degraded first among equals.
+    int    best_slot     = -1;
+    int    best_priority = 0;
+    size_t best_steps    = 0;
+    for (auto& kv : streams_) {
+        if (kv.second.applied.empty()) continue;
+        const int p = priority(kv.first);
+        if (best_slot < 0 || p > best_priority ||
+            (p == best_priority && kv.second.applied.size() > best_steps)) {
+            best_slot     = kv.first;
+            best_priority = p;
+            best_steps    = kv.second.applied.size();
+        }
+    }
+    if (best_slot < 0) return;
+
+    StreamState& st   = streams_[best_slot];
+    const Step   step = st.applied.back();
+    undo(best_slot, st, step);
+    st.applied.pop_back();
+    st.next_step = static_cast<int>(step);
+    std::cout << "[QualityController] slot " << best_slot << ": restored ("
+              << step_name(static_cast<int>(step)) << ")\n";
+}
+
+bool QualityController::apply(int slot, StreamState& st, Step step) {
+    RtspStream* stream = st.stream;
+    switch (step) {
+        case Step::InferenceRate: {
+            if (!scheduler_) return false;
+            StreamSchedule sched = scheduler_->schedule(slot);
+            if (sched.target_hz <= 0.0) return false;
+            st.saved_hz      = sched.target_hz;
+            sched.target_hz /= 2.0;
+            st.degraded_hz   = sched.target_hz;
+            scheduler_->configure_stream(slot, sched);
+            return true;
+        }
+        case Step::FrameRate: {
+            const double fps = stream->max_fps();
+            if (fps > 0.0 && fps <= kDegradedFps) return false;
+            st.saved_fps = fps;
+            stream->set_max_fps(kDegradedFps);
+            return true;
+        }
+        case Step::Scale:
+            return stream->downscale() == 1 && stream->set_downscale(2);
+        case Step::KeyframesOnly:
+            if (stream->keyframes_only()) return false;
+            stream->set_keyframes_only(true);
+            return true;
+        case Step::Count:
+            break;
+    }
+    return false;
+}
+
+// Settings changed since (e.g. through the control API) are left alone.
+void QualityController::undo(int slot, StreamState& st, Step step) {
+    RtspStream* stream = st.stream;
+    switch (step) {
+        case Step::InferenceRate: {
+            StreamSchedule sched = scheduler_->schedule(slot);
+            if (sched.target_hz != st.degraded_hz) break;
+            sched.target_hz = st.saved_hz;
+            scheduler_->configure_stream(slot, sched);
+            break;
+        }
+        case Step::FrameRate:
+            if (std::abs(stream->max_fps() - kDegradedFps) < 1e-6) stream->set_max_fps(st.saved_fps);
+            break;
+        case Step::Scale:
+            stream->set_downscale(1);
+            break;
+        case Step::KeyframesOnly:
+            stream->set_keyframes_only(false);
+            break;
+        case Step::Count:
+            break;
+    }
+}
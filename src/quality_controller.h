@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class InferenceScheduler;
+class RtspStream;
+class RtspStreamManager;
+class VideoRenderer;
+
+// Overload thresholds. A metric past its threshold means overload; every
+// metric below `headroom` × its threshold means there is room to restore.
+struct QualityTargets {
+    double render_period_ms     = 25.0;   // VideoRenderer::frame_period_ms(); ignored headless
+    double decode_lag_ms        = 250.0;  // worst RtspStream::decode_lag_ms()
+    double inference_miss_ratio = 0.2;    // deadline misses per inference, input-limited streams excluded
+    double headroom             = 0.6;
+    double interval_ms          = 500.0;  // evaluation window
+    int    degrade_after        = 2;      // consecutive overloaded windows
+    int    restore_after        = 10;     // consecutive windows with headroom
+};
+
+// Adaptive quality degradation under CPU/GPU overload.
+//
+// Rather than letting every stream degrade together when the box saturates,
+// the controller applies degradations one step at a time, lowest-priority
+// stream first (inference priority; equal priorities take turns), and undoes
+// them in reverse once headroom returns. Each stream climbs its own ladder:
+//
+//   1. inference rate halved
+//   2. delivery capped at kDegradedFps
+//   3. mapped RGB output scaled to half size
+//   4. keyframe-only decoding
+//
+// Steps that do not apply to a stream (no inference, DMABuf/GL output) are
+// skipped. After every step the counters restart, so the effect of one change
+// is measured before the next. Hysteresis is asymmetric: degrading reacts
+// within a second, restoring waits for sustained headroom.
+//
+// Inference misses only count for streams delivering frames at least as fast
+// as their inference rate: steps 2 and 4 slow a stream's input, and that must
+// not read as more overload. Should overload persist with every ladder
+// exhausted, a step is still restored every kProbeWindows windows, so a
+// stuck metric cannot pin every stream at keyframes-only for good.
+//
+// Main thread only, like ControlServer::apply_pending(): update() runs once
+// per main-loop iteration and reads the manager's streams directly.
+class QualityController {
+public:
+    static constexpr double kDegradedFps  = 10.0;
+    static constexpr int    kProbeWindows = 40;
+
+    // scheduler and renderer may be null.
+    QualityController(RtspStreamManager& manager, InferenceScheduler* scheduler,
+                      const VideoRenderer* renderer, const QualityTargets& targets);
+
+    void update();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Step { InferenceRate, FrameRate, Scale, KeyframesOnly, Count };
+
+    struct StreamState {
+        RtspStream*       stream      = nullptr;
+        uint64_t          stream_id   = 0;        // detects a slot reused by another stream
+        std::vector<Step> applied;                // ladder so far, undone back to front
+        int               next_step   = 0;        // first step degrade() tries
+        double            saved_hz    = 0.0;      // target_hz before Step::InferenceRate
+        double            degraded_hz = 0.0;
+        double            saved_fps   = 0.0;      // max_fps() before Step::FrameRate
+    };
+
+    bool overloaded(double period_ms, double lag_ms, double miss_ratio) const;
+    bool has_headroom(double period_ms, double lag_ms, double miss_ratio) const;
+    double miss_ratio(double window_s);
+    bool degrade();  // false: every ladder exhausted
+    void restore();
+    bool apply(int slot, StreamState& st, Step step);
+    void undo(int slot, StreamState& st, Step step);
+    int  priority(int slot) const;
+
+    RtspStreamManager&         manager_;
+    InferenceScheduler*        scheduler_;
+    const VideoRenderer*       renderer_;
+    QualityTargets             targets_;
+
+    // Scheduler counters at the start of the window, by slot.
+    struct InferenceCounters {
+        uint64_t misses     = 0;
+        uint64_t inferences = 0;
+        uint64_t frames     = 0;
+    };
+
+    std::map<int, StreamState> streams_;  // by slot
+    std::map<int, InferenceCounters> last_counters_;
+    Clock::time_point          window_start_;
+    int                        overloaded_windows_ = 0;
+    int                        headroom_windows_   = 0;
+    int                        exhausted_windows_  = 0;  // overloaded, nothing left to degrade
+};
@@ -0,0 +1,149 @@
+#include "result_timeline.h"
+#include "inference_engine.h"
+
+#include <algorithm>
+#include <chrono>
+
+static int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ResultTimeline::ResultTimeline(size_t capacity_per_stream)
+    : capacity_(std::max<size_t>(capacity_per_stream, 1)) {}
+
+// ---------------------------------------------------------------------------
+// Stream lookup
+// ---------------------------------------------------------------------------
+
+ResultTimeline::Stream* ResultTimeline::stream_for(int slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& st = streams_[slot];
+    if (!st) {
+        st = std::make_unique<Stream>();
+        st->ring.resize(capacity_);
+    }
+    return st.get();
+}
+
+const ResultTimeline::Stream* ResultTimeline::find(int slot) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(slot);
+    return it == streams_.end() ? nullptr : it->second.get();
+}
+
+size_t ResultTimeline::Stream::upper_bound(int64_t pts_ns) const {
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (at(mid).frame.pts_ns <= pts_ns) lo = mid + 1;
+        else                                hi = mid;
+    }
+    return lo;
+}
+
+// ---------------------------------------------------------------------------
+// Recording
+// ---------------------------------------------------------------------------
+
+// Claim the next ring entry (caller holds st.mutex). Slot storage is reused,
+// so steady-state recording does not allocate.
+TimedResult& ResultTimeline::begin_record(Stream& st, const FrameMeta& frame) {
+    // No PTS: nothing to order by. Kept aside for latest(); the ring's history
+    // is left alone.
+    if (frame.pts_ns < 0) {
+        st.untimed_valid = true;
+        TimedResult& r   = st.untimed;
+        r.frame          = frame;
+        r.completed_ns   = steady_now_ns();
+        r.detections.clear();
+        r.outputs.clear();
+        return r;
+    }
+    // Discontinuity: older entries would break PTS ordering.
+    if (st.count > 0 && frame.pts_ns < st.at(st.count - 1).frame.pts_ns) st.count = 0;
+
+    TimedResult& r = st.ring[st.head];
+    st.head  = (st.head + 1) % st.ring.size();
+    st.count = std::min(st.count + 1, st.ring.size());
+
+    r.frame        = frame;
+    r.completed_ns = steady_now_ns();
+    r.detections.clear();
+    r.outputs.clear();
+    return r;
+}
+
+void ResultTimeline::record(const FrameMeta& frame, std::vector<Detection> detections) {
+    Stream* st = stream_for(frame.slot);
+    std::lock_guard<std::mutex> lock(st->mutex);
+    begin_record(*st, frame).detections = std::move(detections);
+}
+
+void ResultTimeline::record_outputs(const FrameMeta& frame, const InferenceEngine& engine) {
+    Stream* st = stream_for(frame.slot);
+    std::lock_guard<std::mutex> lock(st->mutex);
+    TimedResult& r = begin_record(*st, frame);
+    const int n = engine.output_count();
+    r.outputs.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const float* data = engine.output_data(i);
+        const int    size = engine.output_size(i);
+        if (data && size > 0) r.outputs[i].assign(data, data + size);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+
+bool ResultTimeline::lookup(int slot, int64_t pts_ns, TimedResult& out, int64_t max_age_ns) const {
+    const Stream* st = find(slot);
+    if (!st) return false;
+    std::lock_guard<std::mutex> lock(st->mutex);
+    const size_t i = st->upper_bound(pts_ns);
+    if (i == 0) return false;
+    const TimedResult& r = st->at(i - 1);
+    if (max_age_ns >= 0 && pts_ns - r.frame.pts_ns > max_age_ns) return false;
+    out = r;
+    return true;
+}
+
+bool ResultTimeline::exact(int slot, int64_t pts_ns, TimedResult& out) const {
+    const Stream* st = find(slot);
+    if (!st) return false;
+    std::lock_guard<std::mutex> lock(st->mutex);
+    const size_t i = st->upper_bound(pts_ns);
+    if (i == 0 || st->at(i - 1).frame.pts_ns != pts_ns) return false;
+    out = st->at(i - 1);
+    return true;
+}
+
+std::vector<TimedResult> ResultTimeline::range(int slot, int64_t from_ns, int64_t to_ns) const {
+    std::vector<TimedResult> out;
+    const Stream* st = find(slot);
+    if (!st) return out;
+    std::lock_guard<std::mutex> lock(st->mutex);
+    for (size_t i = st->upper_bound(from_ns - 1), end = st->upper_bound(to_ns); i < end; ++i)
+        out.push_back(st->at(i));
+    return out;
+}
+
+bool ResultTimeline::latest(int slot, TimedResult& out) const {
+    const Stream* st = find(slot);
+    if (!st) return false;
+    std::lock_guard<std::mutex> lock(st->mutex);
+    const TimedResult* newest = st->count ? &st->at(st->count - 1) : nullptr;
+    if (st->untimed_valid && (!newest || st->untimed.completed_ns > newest->completed_ns))
+        newest = &st->untimed;
+    if (!newest) return false;
+    out = *newest;
+    return true;
+}
+
+void ResultTimeline::clear(int slot) {
+    Stream* st = stream_for(slot);
+    std::lock_guard<std::mutex> lock(st->mutex);
+    st->count         = 0;
+    st->untimed_valid = false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "detection.h"
+#include "frame_consumer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class InferenceEngine;
+
+// One inference result tied to the frame it was computed on.
+struct TimedResult {
+    FrameMeta                       frame;
+    int64_t                         completed_ns = 0;  // steady clock, inference done
+    std::vector<Detection>          detections;
+    std::vector<std::vector<float>> outputs;           // raw tensors, if recorded
+};
+
+// Per-stream, PTS-indexed ring of inference results.
+//
+// Inference runs behind the video (scheduler queueing, model latency), so the
+// newest result usually belongs to an older frame. Renderers, recorders and
+// exporters look results up by the PTS of the frame they are handling and
+// get the result that was current for that frame, never a newer one.
+//
+// Each stream keeps the last `capacity` results in a preallocated ring; a PTS
+// going backwards (seek, replay loop, camera restart) clears that stream.
+// Results for frames without a PTS stay out of the ring and are only
+// reachable via latest(). Read through the control API ("results").
+// All methods are thread-safe.
+class ResultTimeline {
+public:
+    explicit ResultTimeline(size_t capacity_per_stream = 256);
+
+    void record(const FrameMeta& frame, std::vector<Detection> detections);
+
+    // Copy every output tensor of the engine's last run (call from the
+    // scheduler's result callback while outputs are valid).
+    void record_outputs(const FrameMeta& frame, const InferenceEngine& engine);
+
+    // Newest result whose frame PTS ≤ pts_ns, ignoring results older than
+    // max_age_ns when it is ≥ 0. False if none.
+    bool lookup(int slot, int64_t pts_ns, TimedResult& out, int64_t max_age_ns = -1) const;
+
+    // Result computed on exactly this frame, if that frame was inferred.
+    bool exact(int slot, int64_t pts_ns, TimedResult& out) const;
+
+    // Results with from_ns ≤ PTS ≤ to_ns, oldest first.
+    std::vector<TimedResult> range(int slot, int64_t from_ns, int64_t to_ns) const;
+
+    bool latest(int slot, TimedResult& out) const;
+    void clear(int slot);
+
+private:
+    struct Stream {
+        mutable std::mutex       mutex;
+        std::vector<TimedResult> ring;
+        size_t                   head  = 0;  // next write position
+        size_t                   count = 0;
+        TimedResult              untimed;      // newest result without a PTS
+        bool                     untimed_valid = false;
+
+        const TimedResult& at(size_t i) const { return ring[(head + ring.size() - count + i) % ring.size()]; }
+        size_t upper_bound(int64_t pts_ns) const;  // first index with PTS > pts_ns
+    };
+
+    Stream*       stream_for(int slot);
+    const Stream* find(int slot) const;
+    TimedResult&  begin_record(Stream& st, const FrameMeta& frame);
+
+    size_t                                  capacity_;
+    mutable std::mutex                      mutex_;    // guards the map only
+    std::map<int, std::unique_ptr<Stream>>  streams_;  // never erased
+};
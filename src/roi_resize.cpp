@@ -0,0 +1,145 @@
+#include "roi_resize.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ROI_RESIZE_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ROI_RESIZE_SSE2 1
+#endif
+
+namespace {
+
+constexpr int kWeightBits = 7;
+constexpr int kWeightOne  = 1 << kWeightBits;             // 128
+constexpr int kRoundShift = 2 * kWeightBits;               // 14
+constexpr int kRound      = 1 << (kRoundShift - 1);
+
+// Per destination column: byte offsets of the two source taps + right weight.
+struct HTap {
+    int     off0;
+    int     off1;
+    int16_t w1;
+};
+
+// Horizontal pass for one source row → dst_w * 3 values in [0, 128 * 255].
+void hfilter_row(const uint8_t* row, const std::vector<HTap>& taps, int16_t* out) {
+    for (size_t x = 0; x < taps.size(); ++x) {
+        const HTap& t  = taps[x];
+        const int   w1 = t.w1;
+        const int   w0 = kWeightOne - w1;
+        const uint8_t* a = row + t.off0;
+        const uint8_t* b = row + t.off1;
+        out[x * 3 + 0] = static_cast<int16_t>(a[0] * w0 + b[0] * w1);
+        out[x * 3 + 1] = static_cast<int16_t>(a[1] * w0 + b[1] * w1);
+        out[x * 3 + 2] = static_cast<int16_t>(a[2] * w0 + b[2] * w1);
+    }
+}
+
+// Vertical pass: dst = (r0 * (128 - wy) + r1 * wy + round) >> 14
+void vblend_row(const int16_t* r0, const int16_t* r1, int wy, uint8_t* dst, int n) {
+    int i = 0;
+#if defined(ROI_RESIZE_NEON)
+    const uint16x4_t w0 = vdup_n_u16(static_cast<uint16_t>(kWeightOne - wy));
+    const uint16x4_t w1 = vdup_n_u16(static_cast<uint16_t>(wy));
+    for (; i + 8 <= n; i += 8) {
+        const uint16x8_t a = vreinterpretq_u16_s16(vld1q_s16(r0 + i));
+        const uint16x8_t b = vreinterpretq_u16_s16(vld1q_s16(r1 + i));
+        uint32x4_t lo = vmull_u16(vget_low_u16(a), w0);
+        uint32x4_t hi = vmull_u16(vget_high_u16(a), w0);
+        lo = vmlal_u16(lo, vget_low_u16(b), w1);
+        hi = vmlal_u16(hi, vget_high_u16(b), w1);
+        const uint16x8_t px = vcombine_u16(vrshrn_n_u32(lo, kRoundShift),
+                                           vrshrn_n_u32(hi, kRoundShift));
+        vst1_u8(dst + i, vqmovn_u16(px));
+    }
+#elif defined(ROI_RESIZE_SSE2)
+    // Interleave (r0, r1) pairs so one madd applies both weights.
+    const __m128i w     = _mm_set1_epi32((wy << 16) | (kWeightOne - wy));
+    const __m128i round = _mm_set1_epi32(kRound);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i a  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + i));
+        const __m128i b  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + i));
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), w);
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), w);
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, round), kRoundShift);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, round), kRoundShift);
+        const __m128i px = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(px, px));
+    }
+#endif
+    const int w0 = kWeightOne - wy;
+    for (; i < n; ++i)
+        dst[i] = static_cast<uint8_t>((r0[i] * w0 + r1[i] * wy + kRound) >> kRoundShift);
+}
+
+// Map destination coordinate d ∈ [0, dst_len) to source tap pair + weight,
+// pixel-centre aligned, clamped to [lo, hi].
+inline void map_coord(int d, int dst_len, int roi_start, int roi_len, int lo, int hi,
+                      int& s0, int& s1, int& w1) {
+    const float s = roi_start + (d + 0.5f) * roi_len / dst_len - 0.5f;
+    const float f = std::floor(s);
+    s0 = static_cast<int>(f);
+    w1 = static_cast<int>(std::lround((s - f) * kWeightOne));
+    s1 = s0 + 1;
+    if (w1 >= kWeightOne) { s0 = s1; w1 = 0; }
+    s0 = std::clamp(s0, lo, hi);
+    s1 = std::clamp(s1, lo, hi);
+}
+
+} // namespace
+
+void resize_rgb_roi(const uint8_t* src, int src_w, int src_h, int src_stride,
+                    int roi_x, int roi_y, int roi_w, int roi_h,
+                    uint8_t* dst, int dst_w, int dst_h) {
+    if (!src || !dst || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) return;
+    if (src_stride <= 0) src_stride = src_w * 3;
+
+    // Crop the ROI to the image by its corners, so a box hanging over the
+    // left/top edge loses that part instead of shifting inwards; degenerate
+    // ROIs collapse to one pixel.
+    const int x0 = std::clamp(roi_x, 0, src_w - 1);
+    const int y0 = std::clamp(roi_y, 0, src_h - 1);
+    const int x1 = static_cast<int>(std::clamp<int64_t>(int64_t{roi_x} + roi_w, x0 + 1, src_w));
+    const int y1 = static_cast<int>(std::clamp<int64_t>(int64_t{roi_y} + roi_h, y0 + 1, src_h));
+    roi_x = x0;
+    roi_y = y0;
+    roi_w = x1 - x0;
+    roi_h = y1 - y0;
+
+    std::vector<HTap> taps(dst_w);
+    for (int x = 0; x < dst_w; ++x) {
+        int s0, s1, w1;
+        map_coord(x, dst_w, roi_x, roi_w, roi_x, roi_x + roi_w - 1, s0, s1, w1);
+        taps[x] = {s0 * 3, s1 * 3, static_cast<int16_t>(w1)};
+    }
+
+    // Two cached horizontally-filtered rows; upscaling reuses them across
+    // many destination rows.
+    const int n = dst_w * 3;
+    std::vector<int16_t> rows(static_cast<size_t>(n) * 2);
+    int16_t* cache[2]  = {rows.data(), rows.data() + n};
+    int      cached[2] = {-1, -1};
+
+    auto filtered = [&](int sy, int which) -> const int16_t* {
+        if (cached[0] == sy) return cache[0];
+        if (cached[1] == sy) return cache[1];
+        // Evict the slot not holding the other tap of this destination row.
+        hfilter_row(src + static_cast<size_t>(sy) * src_stride, taps, cache[which]);
+        cached[which] = sy;
+        return cache[which];
+    };
+
+    for (int y = 0; y < dst_h; ++y) {
+        int s0, s1, wy;
+        map_coord(y, dst_h, roi_y, roi_h, roi_y, roi_y + roi_h - 1, s0, s1, wy);
+        const int16_t* r0 = filtered(s0, cached[1] == s1 ? 0 : (cached[0] == s1 ? 1 : 0));
+        const int16_t* r1 = (s1 == s0) ? r0 : filtered(s1, r0 == cache[0] ? 1 : 0);
+        vblend_row(r0, r1, wy, dst + static_cast<size_t>(y) * n, n);
+    }
+}
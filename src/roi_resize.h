@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// Bilinear resize of a rectangular region of a packed RGB image.
+//
+// src:        RGB24 source, src_stride bytes per row (0 → src_w * 3)
+// roi_*:      source region in pixels, cropped to the image
+// dst:        dst_w × dst_h × 3 bytes, tightly packed
+//
+// Horizontal taps are precomputed per destination column; the vertical blend
+// of two horizontally-filtered rows runs on NEON (ARM) or SSE2 (x86) with a
+// scalar fallback. 7-bit weights; results match a float reference within ±2 LSB.
+void resize_rgb_roi(const uint8_t* src, int src_w, int src_h, int src_stride,
+                    int roi_x, int roi_y, int roi_w, int roi_h,
+                    uint8_t* dst, int dst_w, int dst_h);
+
+// Convenience: whole-image resize.
+inline void resize_rgb(const uint8_t* src, int src_w, int src_h, int src_stride,
+                       uint8_t* dst, int dst_w, int dst_h) {
+    resize_rgb_roi(src, src_w, src_h, src_stride, 0, 0, src_w, src_h, dst, dst_w, dst_h);
+}
@@ -1,38 +1,257 @@
 #include "rtsp_stream_manager.h"
+#include "frame_consumer.h"
+#include "gl_ingest.h"
+#include "sample_pump.h"
 #include "video_renderer.h"
 
+#include <gst/allocators/gstdmabuf.h>
 #include <gst/app/gstappsink.h>
 #include <gst/gst.h>
+#include <gst/video/video.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 
+// ---------------------------------------------------------------------------
+// StreamSource
+// ---------------------------------------------------------------------------
+
+static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+StreamSource StreamSource::from_url(const std::string& url) {
+    StreamSource src;
+    // rtsp://, rtsps://, rtspt://, rtsph:// … all go to rtspsrc.
+    if (url.rfind("rtsp", 0) == 0 && url.find("://") != std::string::npos) {
+        src.kind     = SourceKind::Rtsp;
+        src.location = url;
+        return src;
+    }
+    src.location = (url.rfind("file://", 0) == 0) ? url.substr(7) : url;
+    src.kind     = ends_with(src.location, ".pcap") ? SourceKind::RtpPcap : SourceKind::File;
+    return src;
+}
+
+// ---------------------------------------------------------------------------
+// Output buffer pool
+// ---------------------------------------------------------------------------
+
+// Rows are padded to a multiple of 64 pixels: the stride is then a multiple
+// of 64 bytes (cache line / SIMD friendly) and of 3, so the renderer can
+// upload with GL_UNPACK_ROW_LENGTH instead of repacking.
+static constexpr int kRowAlignPixels = 64;
+
+// Answers the ALLOCATION query reaching the appsink with a video buffer pool
+// of 64-byte-aligned, row-padded buffers sized for the negotiated caps, plus
+// GstVideoMeta so upstream writes into them directly and every buffer carries
+// its real strides. Without this, buffers come from whatever the decoder or
+// videoconvert picked and their layout is only implied by the caps.
+static GstPadProbeReturn propose_aligned_pool(GstPad*, GstPadProbeInfo* info, gpointer) {
+    GstQuery* query = GST_PAD_PROBE_INFO_QUERY(info);
+    if (GST_QUERY_TYPE(query) != GST_QUERY_ALLOCATION) return GST_PAD_PROBE_OK;
+
+    GstCaps*     caps      = nullptr;
+    gboolean     need_pool = FALSE;
+    GstVideoInfo vinfo;
+    gst_query_parse_allocation(query, &caps, &need_pool);
+    if (!caps || !gst_video_info_from_caps(&vinfo, caps)) return GST_PAD_PROBE_OK;
+    // Only system memory: DMABuf output must stay in the decoder's own pool.
+    GstCapsFeatures* features = gst_caps_get_features(caps, 0);
+    if (features && !gst_caps_features_contains(features, GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY))
+        return GST_PAD_PROBE_OK;
+
+    const int width = GST_VIDEO_INFO_WIDTH(&vinfo);
+    GstVideoAlignment align;
+    gst_video_alignment_reset(&align);
+    align.padding_right = (width + kRowAlignPixels - 1) / kRowAlignPixels * kRowAlignPixels - width;
+    for (unsigned i = 0; i < GST_VIDEO_MAX_PLANES; ++i) align.stride_align[i] = 63;
+    if (!gst_video_info_align(&vinfo, &align)) return GST_PAD_PROBE_OK;
+
+    GstAllocationParams params;
+    gst_allocation_params_init(&params);
+    params.align = 63;
+
+    // Two in flight at the appsink (max-buffers=2) plus one being consumed.
+    const guint size        = static_cast<guint>(GST_VIDEO_INFO_SIZE(&vinfo));
+    const guint min_buffers = 3;
+    GstBufferPool* pool   = gst_video_buffer_pool_new();
+    GstStructure*  config = gst_buffer_pool_get_config(pool);
+    gst_buffer_pool_config_set_params(config, caps, size, min_buffers, 0);
+    gst_buffer_pool_config_set_allocator(config, nullptr, &params);
+    gst_buffer_pool_config_add_option(config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+    gst_buffer_pool_config_add_option(config, GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
+    gst_buffer_pool_config_set_video_alignment(config, &align);
+    if (!gst_buffer_pool_set_config(pool, config)) {
+        gst_object_unref(pool);
+        return GST_PAD_PROBE_OK;  // let the default allocation stand
+    }
+
+    gst_query_add_allocation_pool(query, pool, size, min_buffers, 0);
+    gst_query_add_allocation_param(query, nullptr, &params);
+    gst_query_add_allocation_meta(query, GST_VIDEO_META_API_TYPE, nullptr);
+    gst_object_unref(pool);
+    return GST_PAD_PROBE_HANDLED;
+}
+
+// ---------------------------------------------------------------------------
+// DMABuf output
+// ---------------------------------------------------------------------------
+
+// Layouts VideoRenderer can import; all but NV12 map 1:1 to a DRM fourcc.
+static constexpr const char* kDmabufFormats = "{ BGRx, BGRA, RGBx, RGBA, NV12 }";
+
+static uint32_t drm_format_for(GstVideoFormat format) {
+    switch (format) {
+        case GST_VIDEO_FORMAT_BGRx: return kDrmFormatXRGB8888;
+        case GST_VIDEO_FORMAT_BGRA: return kDrmFormatARGB8888;
+        case GST_VIDEO_FORMAT_RGBx: return kDrmFormatXBGR8888;
+        case GST_VIDEO_FORMAT_RGBA: return kDrmFormatABGR8888;
+        case GST_VIDEO_FORMAT_NV12: return kDrmFormatNV12;
+        default:                    return 0;
+    }
+}
+
+// Converts negotiated DMABuf layouts to packed RGB on the CPU once the
+// renderer has refused them (no EGL import), reusing one output buffer.
+struct RtspStream::RgbConverter {
+    GstVideoInfo       in_info;
+    GstVideoInfo       out_info;
+    GstVideoConverter* conv = nullptr;
+    GstBuffer*         out  = nullptr;
+
+    ~RgbConverter() {
+        if (conv) gst_video_converter_free(conv);
+        if (out)  gst_buffer_unref(out);
+    }
+
+    // Returns the converted frame (owned by the converter), or null.
+    GstBuffer* convert(GstCaps* caps, GstBuffer* buffer) {
+        GstVideoInfo info;
+        if (!gst_video_info_from_caps(&info, caps)) return nullptr;
+        if (!conv || !gst_video_info_is_equal(&info, &in_info)) {
+            if (conv) gst_video_converter_free(conv);
+            if (out)  gst_buffer_unref(out);
+            in_info = info;
+            gst_video_info_set_format(&out_info, GST_VIDEO_FORMAT_RGB,
+                                      GST_VIDEO_INFO_WIDTH(&info), GST_VIDEO_INFO_HEIGHT(&info));
+            conv = gst_video_converter_new(&in_info, &out_info, nullptr);
+            out  = gst_buffer_new_allocate(nullptr, GST_VIDEO_INFO_SIZE(&out_info), nullptr);
+        }
+        if (!conv || !out) return nullptr;
+
+        GstVideoFrame src, dst;
+        if (!gst_video_frame_map(&src, &in_info, buffer, GST_MAP_READ)) return nullptr;
+        if (!gst_video_frame_map(&dst, &out_info, out, GST_MAP_WRITE)) {
+            gst_video_frame_unmap(&src);
+            return nullptr;
+        }
+        gst_video_converter_frame(conv, &src, &dst);
+        gst_video_frame_unmap(&dst);
+        gst_video_frame_unmap(&src);
+        return out;
+    }
+};
+
 // ---------------------------------------------------------------------------
 // RtspStream
 // ---------------------------------------------------------------------------
 
 RtspStream::RtspStream(const std::string& url, int slot, VideoRenderer* renderer)
-    : url_(url), slot_(slot), renderer_(renderer) {}
+    : RtspStream(StreamSource::from_url(url), slot, renderer) {}
+
+static std::atomic<uint64_t> g_next_stream_id{1};
+
+RtspStream::RtspStream(const StreamSource& source, int slot, VideoRenderer* renderer)
+    : source_(source), slot_(slot), id_(g_next_stream_id.fetch_add(1)), renderer_(renderer) {}
 
 RtspStream::~RtspStream() { stop(); }
 
+bool RtspStream::dmabuf_output() const {
+    return source_.dmabuf && renderer_ && consumers_.empty();
+}
+
+bool RtspStream::gl_output() const {
+    return source_.gl_upload && gl_ingest_ && renderer_ && consumers_.empty();
+}
+
+std::string RtspStream::build_pipeline_description() const {
+    const std::string decodebin = source_.decode == DecodePolicy::Software
+                                      ? "decodebin force-sw-decoders=true" : "decodebin";
+    std::string src;
+    switch (source_.kind) {
+        case SourceKind::Rtsp:
+            src = "rtspsrc location=" + source_.location;
+            if (source_.transport == RtspTransport::Tcp) src += " protocols=tcp";
+            if (source_.transport == RtspTransport::Udp) src += " protocols=udp";
+            if (source_.latency_ms >= 0) src += " latency=" + std::to_string(source_.latency_ms);
+            src += " ! " + decodebin;
+            break;
+        case SourceKind::File:
+            src = "filesrc location=\"" + source_.location + "\" ! " + decodebin;
+            break;
+        case SourceKind::RtpPcap:
+            // pcapparse restores capture timestamps; the jitterbuffer reorders
+            // and paces RTP exactly as rtspsrc would for a live camera.
+            src = "filesrc location=\"" + source_.location + "\""
+                  " ! pcapparse ! " + source_.rtp_caps +
+                  " ! rtpjitterbuffer ! " + decodebin;
+            break;
+    }
+
+    const bool pull = delivery_ != SampleDelivery::Signal;
+    if (!renderer_ && consumers_.empty() && !pull) return src + " ! autovideosink";
+
+    // GStreamer decodes and converts to RGB; appsink hands us raw frames.
+    // Live: max-buffers=2 drop=true keeps the renderer at live speed without backpressure.
+    // Replay: real-time pacing syncs on PTS; as-fast-as-possible never drops so
+    // every run decodes the same frames.
+    std::string sink = std::string(" ! appsink name=sink max-buffers=2 emit-signals=")
+                       + (pull ? "false" : "true");
+    if (source_.kind == SourceKind::Rtsp)
+        sink += " sync=false drop=true";
+    else if (source_.pacing == ReplayPacing::RealTime)
+        sink += " sync=true drop=false";
+    else
+        sink += " sync=false drop=false";
+
+    // GL output: GStreamer's GL thread uploads and converts, the appsink
+    // receives RGBA textures in the context shared with the renderer.
+    if (gl_output())
+        return src + " ! glupload ! glcolorconvert"
+                     " ! video/x-raw(memory:GLMemory),format=RGBA,texture-target=2D" + sink;
+
+    // DMABuf output passes videoconvert untouched; packed RGB stays as the
+    // alternative for decoders that cannot produce it.
+    if (dmabuf_output())
+        return src + " ! videoconvert"
+                     " ! video/x-raw(memory:DMABuf),format=" + kDmabufFormats + ";video/x-raw,format=RGB" + sink;
+
+    // videoscale passes frames through until set_downscale() constrains the
+    // output caps; scaling before conversion also makes that cheaper.
+    return src +
+           " ! videoscale name=scale ! videoconvert"
+           " ! capsfilter name=outcaps caps=video/x-raw,format=RGB" + sink;
+}
+
 bool RtspStream::start() {
     if (pipeline_) {
-        std::cout << "Stream already started: " << url_ << "\n";
+        std::cout << "Stream already started: " << source_.location << "\n";
         return true;
     }
 
-    std::string pipeline_str;
-    if (renderer_) {
-        // GStreamer decodes and converts to RGB; appsink hands us raw frames.
-        // max-buffers=2 drop=true keeps the renderer at live speed without backpressure.
-        pipeline_str =
-            "rtspsrc location=" + url_ +
-            " ! decodebin"
-            " ! videoconvert"
-            " ! video/x-raw,format=RGB"
-            " ! appsink name=sink sync=false max-buffers=2 drop=true emit-signals=true";
-    } else {
-        pipeline_str = "rtspsrc location=" + url_ + " ! decodebin ! autovideosink";
-    }
+    if (delivery_ == SampleDelivery::Pool && !pump_) delivery_ = SampleDelivery::Pull;
+    const std::string pipeline_str = build_pipeline_description();
+    frames_received_     = 0;
+    frames_rate_limited_ = 0;
+    last_delivered_ns_   = 0;
+    finished_            = false;
+    decode_lag_ms_       = 0.0;
+    lag_valid_           = false;
+    skipping_deltas_     = false;
+    downscale_           = 1;
 
     GError* error = nullptr;
     pipeline_ = gst_parse_launch(pipeline_str.c_str(), &error);
@@ -41,61 +260,337 @@ bool RtspStream::start() {
         g_error_free(error);
         return false;
     }
+    if (gl_output()) gl_ingest_->attach(pipeline_);
+    // decodebin plugs the decoder once the stream type is known.
+    g_signal_connect(pipeline_, "deep-element-added", G_CALLBACK(on_element_added), this);
 
-    if (renderer_) {
-        GstElement* appsink = gst_bin_get_by_name(GST_BIN(pipeline_), "sink");
-        if (appsink) {
-            g_signal_connect(appsink, "new-sample", G_CALLBACK(on_new_sample), this);
-            gst_object_unref(appsink);
+    if (GstElement* appsink = gst_bin_get_by_name(GST_BIN(pipeline_), "sink")) {
+        if (GstPad* pad = gst_element_get_static_pad(appsink, "sink")) {
+            gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM,
+                              propose_aligned_pool, nullptr, nullptr);
+            gst_object_unref(pad);
         }
+        if (delivery_ == SampleDelivery::Pool)
+            pump_->add(this, GST_APP_SINK(appsink));
+        else if (delivery_ == SampleDelivery::Signal)
+            g_signal_connect(appsink, "new-sample", G_CALLBACK(on_new_sample), this);
+        gst_object_unref(appsink);
     }
 
     GstStateChangeReturn ret = gst_element_set_state(pipeline_, GST_STATE_PLAYING);
     if (ret == GST_STATE_CHANGE_FAILURE) {
-        std::cerr << "Failed to start pipeline for: " << url_ << "\n";
+        std::cerr << "Failed to start pipeline for: " << source_.location << "\n";
+        gst_element_set_state(pipeline_, GST_STATE_NULL);
+        if (delivery_ == SampleDelivery::Pool) pump_->remove(this);
         gst_object_unref(pipeline_);
         pipeline_ = nullptr;
         return false;
     }
 
+    if (source_.kind != SourceKind::Rtsp) {
+        bus_running_ = true;
+        bus_thread_  = std::thread(&RtspStream::bus_worker, this);
+    }
+    if (delivery_ == SampleDelivery::Pull) {
+        pull_running_ = true;
+        pull_thread_  = std::thread(&RtspStream::pull_worker, this);
+    }
+
     playing_ = true;
-    std::cout << "[slot " << slot_ << "] Started: " << url_ << "\n";
+    std::cout << "[slot " << slot_ << "] Started: " << source_.location << "\n";
     return true;
 }
 
 void RtspStream::stop() {
+    pull_running_ = false;
+    if (pull_thread_.joinable()) pull_thread_.join();
+    bus_running_ = false;
+    if (bus_thread_.joinable()) bus_thread_.join();
+
     if (pipeline_) {
         gst_element_set_state(pipeline_, GST_STATE_NULL);
+        // NULL joined the streaming threads: no more new_sample announcements.
+        if (delivery_ == SampleDelivery::Pool) pump_->remove(this);
         gst_object_unref(pipeline_);
         pipeline_ = nullptr;
     }
     playing_ = false;
 }
 
+void RtspStream::bus_worker() {
+    GstBus* bus = gst_element_get_bus(pipeline_);
+    while (bus_running_) {
+        GstMessage* msg = gst_bus_timed_pop_filtered(
+            bus, 100 * GST_MSECOND,
+            static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+        if (!msg) continue;
+
+        if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS) {
+            if (source_.loop &&
+                gst_element_seek_simple(pipeline_, GST_FORMAT_TIME,
+                    static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT), 0)) {
+                std::cout << "[slot " << slot_ << "] Replay looped: " << source_.location << "\n";
+            } else {
+                finished_ = true;
+                std::cout << "[slot " << slot_ << "] Replay finished after "
+                          << frames_received() << " frames: " << source_.location << "\n";
+            }
+        } else {
+            GError* err = nullptr;
+            gst_message_parse_error(msg, &err, nullptr);
+            std::cerr << "[slot " << slot_ << "] Replay error: "
+                      << (err ? err->message : "unknown") << "\n";
+            if (err) g_error_free(err);
+            finished_ = true;
+        }
+        gst_message_unref(msg);
+    }
+    gst_object_unref(bus);
+}
+
+void RtspStream::set_max_fps(double fps) {
+    min_interval_ns_.store(fps > 0.0 ? static_cast<int64_t>(1e9 / fps) : 0, std::memory_order_relaxed);
+}
+
+double RtspStream::max_fps() const {
+    const int64_t interval = min_interval_ns_.load(std::memory_order_relaxed);
+    return interval > 0 ? 1e9 / static_cast<double>(interval) : 0.0;
+}
+
+// ---------------------------------------------------------------------------
+// Degradations
+// ---------------------------------------------------------------------------
+
+void RtspStream::on_element_added(GstBin*, GstBin*, GstElement* element, gpointer user_data) {
+    GstElementFactory* factory = gst_element_get_factory(element);
+    const char* klass = factory ? gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS)
+                                : nullptr;
+    if (!klass || !std::strstr(klass, "Decoder") || !std::strstr(klass, "Video")) return;
+    if (GstPad* pad = gst_element_get_static_pad(element, "sink")) {
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, skip_delta_units, user_data, nullptr);
+        gst_object_unref(pad);
+    }
+}
+
+GstPadProbeReturn RtspStream::skip_delta_units(GstPad*, GstPadProbeInfo* info, gpointer user_data) {
+    auto* self = static_cast<RtspStream*>(user_data);
+    const bool wanted = self->keyframes_only_.load(std::memory_order_relaxed);
+    // Keyframes decide whether the GOP they start is skipped, so turning the
+    // mode off never feeds the decoder a delta unit whose reference was dropped.
+    if (!GST_BUFFER_FLAG_IS_SET(GST_PAD_PROBE_INFO_BUFFER(info), GST_BUFFER_FLAG_DELTA_UNIT)) {
+        self->skipping_deltas_ = wanted;
+        return GST_PAD_PROBE_OK;
+    }
+    if (wanted) self->skipping_deltas_ = true;
+    return self->skipping_deltas_ ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+}
+
+bool RtspStream::set_downscale(int divisor) {
+    divisor = std::max(1, divisor);
+    if (!pipeline_) return false;
+    GstElement* scale  = gst_bin_get_by_name(GST_BIN(pipeline_), "scale");
+    GstElement* filter = gst_bin_get_by_name(GST_BIN(pipeline_), "outcaps");
+    // Native size: what the decoder feeds the scaler.
+    int width = 0, height = 0;
+    if (GstPad* pad = scale ? gst_element_get_static_pad(scale, "sink") : nullptr) {
+        if (GstCaps* caps = gst_pad_get_current_caps(pad)) {
+            GstStructure* s = gst_caps_get_structure(caps, 0);
+            gst_structure_get_int(s, "width",  &width);
+            gst_structure_get_int(s, "height", &height);
+            gst_caps_unref(caps);
+        }
+        gst_object_unref(pad);
+    }
+
+    const bool ok = filter && width > 0 && height > 0;
+    if (ok) {
+        GstCaps* caps = gst_caps_new_simple("video/x-raw", "format", G_TYPE_STRING, "RGB", nullptr);
+        if (divisor > 1)
+            gst_caps_set_simple(caps, "width",  G_TYPE_INT, std::max(2, (width / divisor) & ~1),
+                                      "height", G_TYPE_INT, std::max(2, (height / divisor) & ~1), nullptr);
+        g_object_set(filter, "caps", caps, nullptr);  // renegotiates from the next frame
+        gst_caps_unref(caps);
+        downscale_ = divisor;
+    }
+    if (scale)  gst_object_unref(scale);
+    if (filter) gst_object_unref(filter);
+    return ok;
+}
+
+void RtspStream::update_decode_lag(GstBuffer* buffer) {
+    if (!GST_BUFFER_PTS_IS_VALID(buffer)) return;
+    const int64_t pts = static_cast<int64_t>(GST_BUFFER_PTS(buffer));
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const int64_t offset = now - pts;
+    // Base: the least-delayed frame, creeping up slowly to follow sender
+    // clock drift. PTS stepping back (loop, seek) starts over.
+    if (!lag_valid_ || pts < lag_last_pts_ns_ - GST_SECOND) {
+        lag_base_ns_ = offset;
+        lag_valid_   = true;
+    } else if (offset < lag_base_ns_) {
+        lag_base_ns_ = offset;
+    } else {
+        lag_base_ns_ += (offset - lag_base_ns_) / 4096;
+    }
+    lag_last_pts_ns_ = pts;
+    // Time-based smoothing (~0.5 s): sparse frames, e.g. keyframes only,
+    // still refresh the estimate.
+    const double alpha  = std::min(1.0, static_cast<double>(now - lag_last_ns_) / 5e8);
+    const double lag_ms = (offset - lag_base_ns_) / 1e6;
+    lag_last_ns_ = now;
+    decode_lag_ms_.store((1.0 - alpha) * decode_lag_ms_.load(std::memory_order_relaxed) + alpha * lag_ms,
+                         std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------
+// Delivery
+// ---------------------------------------------------------------------------
+
+void RtspStream::pull_worker() {
+    GstElement* element = gst_bin_get_by_name(GST_BIN(pipeline_), "sink");
+    if (!element) return;
+    GstAppSink* appsink = GST_APP_SINK(element);
+
+    // The timeout bounds how long stop() waits for this thread.
+    while (pull_running_) {
+        GstSample* sample = gst_app_sink_try_pull_sample(appsink, 100 * GST_MSECOND);
+        if (sample) {
+            deliver_sample(sample);
+        } else if (gst_app_sink_is_eos(appsink)) {
+            // try_pull returns at once while at EOS; a loop seek clears it.
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    gst_object_unref(element);
+}
+
 GstFlowReturn RtspStream::on_new_sample(GstAppSink* appsink, gpointer user_data) {
     auto* self = static_cast<RtspStream*>(user_data);
-    if (!self->renderer_) return GST_FLOW_OK;
+    if (!self->renderer_ && self->consumers_.empty()) return GST_FLOW_OK;
 
     GstSample* sample = gst_app_sink_pull_sample(appsink);
-    if (!sample) return GST_FLOW_OK;
+    if (sample) self->deliver_sample(sample);
+    return GST_FLOW_OK;
+}
+
+void RtspStream::deliver_sample(GstSample* sample) {
+    update_decode_lag(gst_sample_get_buffer(sample));
+
+    // Rate cap: drop before mapping so skipped frames cost nothing downstream.
+    if (const int64_t interval = min_interval_ns_.load(std::memory_order_relaxed)) {
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (now - last_delivered_ns_ < interval) {
+            frames_rate_limited_.fetch_add(1, std::memory_order_relaxed);
+            gst_sample_unref(sample);
+            return;
+        }
+        // Advance by whole intervals so the average rate matches the cap.
+        last_delivered_ns_ = (now - last_delivered_ns_ < 2 * interval)
+                                 ? last_delivered_ns_ + interval : now;
+    }
 
     GstCaps*      caps = gst_sample_get_caps(sample);
     GstStructure* s    = gst_caps_get_structure(caps, 0);
     int width = 0, height = 0;
     gst_structure_get_int(s, "width",  &width);
     gst_structure_get_int(s, "height", &height);
+    GstBuffer* const sample_buffer = gst_sample_get_buffer(sample);
+    GstBuffer*       buffer        = sample_buffer;
+    const int64_t    pts_ns        = GST_BUFFER_PTS_IS_VALID(sample_buffer)
+                                         ? static_cast<int64_t>(GST_BUFFER_PTS(sample_buffer)) : -1;
+
+    // Negotiated GL output: the renderer samples the texture itself. Should it
+    // refuse, the converter below downloads the frame like any other.
+    GstCapsFeatures* features = gst_caps_get_features(caps, 0);
+    if (features && gst_caps_features_contains(features, "memory:GLMemory")) {
+        GlTextureFrame frame;
+        if (gl_ingest_ && gl_ingest_->wrap(sample_buffer, width, height, frame) &&
+            renderer_->push_texture(slot_, std::move(frame), pts_ns)) {
+            frames_received_.fetch_add(1, std::memory_order_relaxed);
+            gst_sample_unref(sample);
+            return;
+        }
+    }
+
+    const char* format = gst_structure_get_string(s, "format");
+    if (width > 0 && height > 0 && format && std::strcmp(format, "RGB") != 0) {
+        // Negotiated DMABuf output: zero-copy to the renderer, else convert.
+        if (push_dmabuf(caps, sample_buffer, pts_ns)) {
+            frames_received_.fetch_add(1, std::memory_order_relaxed);
+            gst_sample_unref(sample);
+            return;
+        }
+        if (!converter_) converter_ = std::make_unique<RgbConverter>();
+        buffer = converter_->convert(caps, sample_buffer);
+        if (!buffer) width = 0;  // unconvertible: drop
+    }
 
     if (width > 0 && height > 0) {
-        GstBuffer* buffer = gst_sample_get_buffer(sample);
+        // Row layout: GstVideoMeta when upstream attached one (our pool always
+        // does), otherwise GStreamer's default for packed RGB (rows padded to 4).
+        int    stride = GST_ROUND_UP_4(width * 3);
+        size_t offset = 0;
+        if (GstVideoMeta* vmeta = gst_buffer_get_video_meta(buffer)) {
+            stride = vmeta->stride[0];
+            offset = vmeta->offset[0];
+        }
+        const size_t needed = offset + static_cast<size_t>(stride) * (height - 1) + width * 3;
+
         GstMapInfo map;
         if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-            self->renderer_->push_frame(self->slot_, map.data, width, height);
+            if (map.size >= needed && stride >= width * 3) {
+                const uint8_t* data = map.data + offset;
+                FrameMeta meta;
+                meta.slot        = slot_;
+                meta.pts_ns      = pts_ns;
+                meta.frame_index = frames_received_.load(std::memory_order_relaxed);
+
+                if (renderer_)
+                    renderer_->push_frame(slot_, data, width, height, stride, pts_ns);
+                for (FrameConsumer* c : consumers_)
+                    c->on_frame(meta, data, width, height, stride);
+                frames_received_.fetch_add(1, std::memory_order_relaxed);
+            }
             gst_buffer_unmap(buffer, &map);
         }
     }
 
     gst_sample_unref(sample);
-    return GST_FLOW_OK;
+}
+
+bool RtspStream::push_dmabuf(GstCaps* caps, GstBuffer* buffer, int64_t pts_ns) {
+    if (!renderer_ || !renderer_->accepts_dmabuf()) return false;
+
+    GstVideoInfo info;
+    if (!gst_video_info_from_caps(&info, caps)) return false;
+    DmabufFrame frame;
+    frame.drm_format = drm_format_for(GST_VIDEO_INFO_FORMAT(&info));
+    frame.width      = GST_VIDEO_INFO_WIDTH(&info);
+    frame.height     = GST_VIDEO_INFO_HEIGHT(&info);
+    frame.num_planes = static_cast<int>(GST_VIDEO_INFO_N_PLANES(&info));
+    if (!frame.drm_format || frame.num_planes > DmabufFrame::kMaxPlanes) return false;
+
+    // Planes may live in separate memories; locate each plane's fd and the
+    // offset within it from the video meta (or the caps' default layout).
+    GstVideoMeta* vmeta = gst_buffer_get_video_meta(buffer);
+    for (int p = 0; p < frame.num_planes; ++p) {
+        const gsize offset = vmeta ? vmeta->offset[p] : GST_VIDEO_INFO_PLANE_OFFSET(&info, p);
+        const gint  stride = vmeta ? vmeta->stride[p] : GST_VIDEO_INFO_PLANE_STRIDE(&info, p);
+        guint idx = 0, length = 0;
+        gsize skip = 0;
+        if (!gst_buffer_find_memory(buffer, offset, 1, &idx, &length, &skip)) return false;
+        GstMemory* mem = gst_buffer_peek_memory(buffer, idx);
+        if (!gst_is_dmabuf_memory(mem)) return false;
+        frame.fd[p]     = gst_dmabuf_memory_get_fd(mem);
+        frame.offset[p] = static_cast<uint32_t>(mem->offset + skip);
+        frame.stride[p] = static_cast<uint32_t>(stride);
+    }
+
+    frame.keepalive = std::shared_ptr<void>(gst_buffer_ref(buffer),
+                                            [](void* b) { gst_buffer_unref(static_cast<GstBuffer*>(b)); });
+    return renderer_->push_dmabuf(slot_, std::move(frame), pts_ns);
 }
 
 // ---------------------------------------------------------------------------
@@ -104,18 +599,71 @@ GstFlowReturn RtspStream::on_new_sample(GstAppSink* appsink, gpointer user_data)
 
 RtspStreamManager::RtspStreamManager() {}
 
+void RtspStreamManager::set_delivery(SampleDelivery delivery, int pool_threads) {
+    delivery_ = delivery;
+    if (delivery == SampleDelivery::Pool && !pump_) {
+        if (pool_threads <= 0)
+            pool_threads = std::max(1, (int)std::thread::hardware_concurrency() / 2);
+        pump_ = std::make_unique<SamplePump>(pool_threads);
+    }
+}
+
 RtspStreamManager::~RtspStreamManager() { stop_all_streams(); }
 
 int RtspStreamManager::add_stream(const std::string& rtsp_url) {
-    int slot = (int)streams_.size();
-    auto stream = std::make_unique<RtspStream>(rtsp_url, slot, renderer_);
+    return add_stream(StreamSource::from_url(rtsp_url));
+}
+
+int RtspStreamManager::add_stream(const StreamSource& source) {
+    int slot = 0;
+    while (find_stream(slot)) ++slot;
+    if (slot_capacity_ > 0 && slot >= slot_capacity_) {
+        std::cerr << "No free slot for " << source.location << "\n";
+        return -1;
+    }
+    auto stream = std::make_unique<RtspStream>(source, slot, renderer_);
+    for (FrameConsumer* c : consumers_) stream->add_consumer(c);
+    if (source.gl_upload && renderer_) {
+        // Wrap the renderer's context once for all streams, on the thread
+        // where it is current. Without it the stream keeps the mapped RGB path.
+        if (!gl_ingest_ && !gl_ingest_failed_) {
+            renderer_->run_in_context([this] { gl_ingest_ = GlIngest::create(renderer_->share_handles()); });
+            gl_ingest_failed_ = !gl_ingest_;
+        }
+        stream->set_gl_ingest(gl_ingest_.get());
+    }
+    stream->set_delivery(delivery_, pump_.get());
     stream->start();
     streams_.push_back(std::move(stream));
     return slot;
 }
 
+bool RtspStreamManager::remove_stream(int slot) {
+    auto it = std::find_if(streams_.begin(), streams_.end(),
+                           [&](const std::unique_ptr<RtspStream>& s) { return s->get_slot() == slot; });
+    if (it == streams_.end()) return false;
+    (*it)->stop();  // joins the pull thread and stops the pipeline: no callbacks after this
+    streams_.erase(it);
+    return true;
+}
+
+RtspStream* RtspStreamManager::find_stream(int slot) const {
+    for (const auto& s : streams_)
+        if (s->get_slot() == slot) return s.get();
+    return nullptr;
+}
+
+bool RtspStreamManager::all_finished() const {
+    if (streams_.empty()) return false;
+    for (const auto& s : streams_)
+        if (!s->finished()) return false;
+    return true;
+}
+
 void RtspStreamManager::stop_all_streams() {
     for (auto& s : streams_) s->stop();
     streams_.clear();
+    gl_ingest_.reset();  // before gst_deinit() and the renderer's context go
+    gl_ingest_failed_ = false;
     std::cout << "All streams stopped\n";
 }
@@ -2,31 +2,177 @@
 
 #include <gst/gst.h>
 #include <gst/app/gstappsink.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <thread>
 #include <vector>
 #include <memory>
 
 class VideoRenderer;
+class FrameConsumer;
+class SamplePump;
+class GlIngest;
+
+// Where a stream's encoded video comes from.
+enum class SourceKind {
+    Rtsp,     // live camera: rtspsrc
+    File,     // local MP4/MKV: filesrc ! decodebin (demuxer autoplugged)
+    RtpPcap,  // recorded RTP capture: filesrc ! pcapparse ! rtpjitterbuffer
+};
+
+// Delivery rate for file-backed sources (ignored for live RTSP).
+enum class ReplayPacing {
+    RealTime,          // appsink sync=true: frames released at their PTS
+    AsFastAsPossible,  // appsink sync=false: decode is the only limit
+};
+
+// RTP lower transport negotiated by rtspsrc.
+enum class RtspTransport {
+    Auto,  // rtspsrc default: UDP, falling back to TCP
+    Tcp,   // interleaved over the RTSP connection (lossy networks, NAT)
+    Udp,
+};
+
+enum class DecodePolicy {
+    Auto,      // highest-ranked decoder, hardware when available
+    Software,  // decodebin force-sw-decoders: predictable CPU cost, no HW limits
+};
+
+// How decoded frames leave the appsink.
+enum class SampleDelivery {
+    Signal,  // "new-sample" callback on the GStreamer streaming thread
+    Pull,    // per-stream worker thread pulling with gst_app_sink_try_pull_sample
+    Pool,    // shared SamplePump threads serve every appsink
+};
+
+struct StreamSource {
+    SourceKind   kind     = SourceKind::Rtsp;
+    std::string  location;                       // rtsp:// URL or local file path
+    ReplayPacing pacing   = ReplayPacing::RealTime;
+    bool         loop     = false;               // File only: seek to 0 on EOS
+    // Rtsp only: transport and jitterbuffer latency (-1 keeps rtspsrc's 2000 ms).
+    RtspTransport transport  = RtspTransport::Auto;
+    int           latency_ms = -1;
+    DecodePolicy  decode     = DecodePolicy::Auto;
+    // Display-only streams (renderer, no consumers): accept DMABuf decoder
+    // output and hand it to VideoRenderer::push_dmabuf without a CPU copy.
+    bool          dmabuf     = false;
+    // Display-only streams: glupload ! glcolorconvert in a GL context shared
+    // with the renderer, which draws the GstGLMemory textures directly.
+    bool          gl_upload  = false;
+    // RtpPcap only: caps of the captured RTP payload.
+    std::string  rtp_caps = "application/x-rtp,media=video,clock-rate=90000,"
+                            "encoding-name=H264,payload=96";
+
+    // rtsp[s|t|h]://… → Rtsp, *.pcap → RtpPcap, anything else (optionally file://) → File.
+    static StreamSource from_url(const std::string& url);
+};
 
 class RtspStream {
 public:
     RtspStream(const std::string& url, int slot, VideoRenderer* renderer);
+    RtspStream(const StreamSource& source, int slot, VideoRenderer* renderer);
     ~RtspStream();
 
+    // Register before start(): receives every decoded frame on the streaming
+    // thread, after the renderer. Not owned.
+    void add_consumer(FrameConsumer* consumer) { consumers_.push_back(consumer); }
+    // Set before start(). Pull and Pool always terminate the pipeline in an
+    // appsink, even with no renderer or consumers, so headless streams still
+    // count frames instead of opening an autovideosink window. Pool needs the
+    // pump (not owned) that will serve this stream.
+    void set_delivery(SampleDelivery delivery, SamplePump* pump = nullptr) {
+        delivery_ = delivery;
+        pump_     = pump;
+    }
+    // Set before start(); used when source.gl_upload. Not owned.
+    void set_gl_ingest(GlIngest* ingest) { gl_ingest_ = ingest; }
+
     bool start();
     void stop();
     bool is_playing() const { return playing_; }
-    const std::string& get_url() const { return url_; }
+    const std::string& get_url() const { return source_.location; }
+    const StreamSource& get_source() const { return source_; }
     int get_slot() const { return slot_; }
+    // Unique for the process lifetime, unlike the slot or the object address.
+    uint64_t id() const { return id_; }
+
+    // Cap the rate at which frames reach the renderer and consumers; excess
+    // frames are dropped at the appsink. 0 removes the cap. Any thread; takes
+    // effect on the next frame.
+    void   set_max_fps(double fps);
+    double max_fps() const;
+
+    // Decoded frames delivered to the appsink since start().
+    uint64_t frames_received() const { return frames_received_.load(std::memory_order_relaxed); }
+    // Frames dropped by the max_fps cap since start().
+    uint64_t frames_rate_limited() const { return frames_rate_limited_.load(std::memory_order_relaxed); }
+    // File sources: true once EOS was reached without looping.
+    bool finished() const { return finished_; }
+
+    // Smoothed delay of frames reaching the appsink relative to their PTS,
+    // above that of the least-delayed frame: grows once decoding (or the
+    // network) falls behind real time.
+    double decode_lag_ms() const { return decode_lag_ms_.load(std::memory_order_relaxed); }
+
+    // Overload degradations (see QualityController).
+    // Keyframe-only drops delta units ahead of the decoder. Any thread; when
+    // turned off, decoding resumes at the next keyframe.
+    void set_keyframes_only(bool on) { keyframes_only_.store(on, std::memory_order_relaxed); }
+    bool keyframes_only() const { return keyframes_only_.load(std::memory_order_relaxed); }
+    // Scale mapped RGB output down by `divisor` (1: native size). Main thread.
+    // False for DMABuf/GL output, which has no scaler, and before the first
+    // frame has been negotiated.
+    bool set_downscale(int divisor);
+    int  downscale() const { return downscale_; }
 
 private:
+    friend class SamplePump;
+
     static GstFlowReturn on_new_sample(GstAppSink* sink, gpointer user_data);
+    static void on_element_added(GstBin* bin, GstBin* sub_bin, GstElement* element, gpointer user_data);
+    static GstPadProbeReturn skip_delta_units(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    void update_decode_lag(GstBuffer* buffer);
+    void deliver_sample(GstSample* sample);  // consumes the sample reference
+    bool push_dmabuf(GstCaps* caps, GstBuffer* buffer, int64_t pts_ns);
+    bool dmabuf_output() const;
+    bool gl_output() const;
+    std::string build_pipeline_description() const;
+    void bus_worker();   // file sources: handles EOS (loop/finish) and errors
+    void pull_worker();  // SampleDelivery::Pull
 
-    std::string    url_;
+    StreamSource   source_;
     int            slot_     = 0;
+    uint64_t       id_       = 0;
     GstElement*    pipeline_ = nullptr;
     bool           playing_  = false;
     VideoRenderer* renderer_ = nullptr;
+    std::vector<FrameConsumer*> consumers_;
+    SampleDelivery delivery_ = SampleDelivery::Signal;
+    SamplePump*    pump_     = nullptr;
+    GlIngest*      gl_ingest_ = nullptr;
+    // CPU fallback for DMABuf output the renderer could not import.
+    struct RgbConverter;
+    std::unique_ptr<RgbConverter> converter_;
+
+    std::atomic<uint64_t> frames_received_{0};
+    std::atomic<uint64_t> frames_rate_limited_{0};
+    std::atomic<int64_t>  min_interval_ns_{0};    // from set_max_fps()
+    int64_t               last_delivered_ns_ = 0; // delivering thread only
+    std::atomic<bool>     finished_{false};
+    std::atomic<double>   decode_lag_ms_{0.0};
+    bool                  lag_valid_       = false;  // delivering thread only
+    int64_t               lag_base_ns_     = 0;
+    int64_t               lag_last_pts_ns_ = 0;
+    int64_t               lag_last_ns_     = 0;
+    std::atomic<bool>     keyframes_only_{false};
+    bool                  skipping_deltas_ = false;  // decoder's streaming thread only
+    int                   downscale_       = 1;
+    std::atomic<bool>     bus_running_{false};
+    std::thread           bus_thread_;
+    std::atomic<bool>     pull_running_{false};
+    std::thread           pull_thread_;
 };
 
 class RtspStreamManager {
@@ -35,12 +181,35 @@ public:
     ~RtspStreamManager();
 
     void set_renderer(VideoRenderer* renderer) { renderer_ = renderer; }
+    // Attached to every stream added afterwards. Not owned.
+    void add_consumer(FrameConsumer* consumer) { consumers_.push_back(consumer); }
+    // Applied to every stream added afterwards. Pool starts a SamplePump with
+    // pool_threads workers (0: half the hardware threads) shared by all streams.
+    void set_delivery(SampleDelivery delivery, int pool_threads = 0);
 
-    // Adds a stream and assigns it the next available slot. Returns the slot index.
+    // Upper bound on slot indices (the renderer's cell count); 0 = unbounded.
+    void set_slot_capacity(int slots) { slot_capacity_ = slots; }
+
+    // Adds a stream and assigns it the lowest free slot. Returns the slot
+    // index, or -1 if every slot is taken.
     int add_stream(const std::string& rtsp_url);
+    int add_stream(const StreamSource& source);
+    // Stops the stream and frees its slot for reuse. False if no such slot.
+    bool remove_stream(int slot);
+    RtspStream* find_stream(int slot) const;
     void stop_all_streams();
 
+    // True when every stream is a file source that has reached EOS.
+    bool all_finished() const;
+    const std::vector<std::unique_ptr<RtspStream>>& streams() const { return streams_; }
+
 private:
+    std::unique_ptr<SamplePump>              pump_;       // outlives streams_
+    std::unique_ptr<GlIngest>                gl_ingest_;  // first gl_upload stream until stop_all_streams()
     std::vector<std::unique_ptr<RtspStream>> streams_;
     VideoRenderer* renderer_ = nullptr;
+    std::vector<FrameConsumer*> consumers_;
+    SampleDelivery delivery_      = SampleDelivery::Signal;
+    int            slot_capacity_ = 0;
+    bool           gl_ingest_failed_ = false;  // don't retry GlIngest::create
 };
@@ -0,0 +1,110 @@
+#include "sample_pump.h"
+#include "rtsp_stream_manager.h"
+
+#include <algorithm>
+#include <iostream>
+
+SamplePump::SamplePump(int num_threads) {
+    num_threads = std::max(1, num_threads);
+    for (int i = 0; i < num_threads; ++i)
+        threads_.emplace_back(&SamplePump::worker, this);
+    std::cout << "[SamplePump] " << num_threads << " consumer thread(s)\n";
+}
+
+SamplePump::~SamplePump() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    ready_cv_.notify_all();
+    for (auto& t : threads_) t.join();
+    for (auto& e : entries_) gst_object_unref(e->appsink);
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+void SamplePump::add(RtspStream* stream, GstAppSink* appsink) {
+    auto entry     = std::make_unique<Entry>();
+    entry->pump    = this;
+    entry->stream  = stream;
+    entry->appsink = GST_APP_SINK(gst_object_ref(appsink));
+
+    GstAppSinkCallbacks callbacks{};
+    callbacks.new_sample = &SamplePump::on_new_sample;
+    gst_app_sink_set_callbacks(appsink, &callbacks, entry.get(), nullptr);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(std::move(entry));
+}
+
+void SamplePump::remove(RtspStream* stream) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [&](const std::unique_ptr<Entry>& e) { return e->stream == stream; });
+    if (it == entries_.end()) return;
+    Entry* entry = it->get();
+
+    idle_cv_.wait(lock, [&] { return !entry->draining; });
+    ready_.erase(std::remove(ready_.begin(), ready_.end(), entry), ready_.end());
+    gst_object_unref(entry->appsink);
+    entries_.erase(it);
+}
+
+// ---------------------------------------------------------------------------
+// Streaming threads: announce only
+// ---------------------------------------------------------------------------
+
+GstFlowReturn SamplePump::on_new_sample(GstAppSink*, gpointer user_data) {
+    auto* entry = static_cast<Entry*>(user_data);
+    // Only the 0 → 1 transition queues the stream; later samples are picked
+    // up by whoever owns it.
+    if (entry->pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+        entry->pump->enqueue(entry);
+    return GST_FLOW_OK;
+}
+
+void SamplePump::enqueue(Entry* entry) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(entry);
+    }
+    ready_cv_.notify_one();
+}
+
+// ---------------------------------------------------------------------------
+// Workers
+// ---------------------------------------------------------------------------
+
+void SamplePump::worker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        ready_cv_.wait(lock, [&] { return !running_ || !ready_.empty(); });
+        if (!running_) return;
+
+        Entry* entry = ready_.front();
+        ready_.pop_front();
+        entry->draining = true;
+        lock.unlock();
+
+        // Drain what was announced when we took the stream. Fewer samples may
+        // be there: drop=true appsinks discard old ones when full.
+        const int announced = entry->pending.load(std::memory_order_acquire);
+        for (int i = 0; i < announced; ++i) {
+            GstSample* sample = gst_app_sink_try_pull_sample(entry->appsink, 0);
+            if (!sample) break;
+            entry->stream->deliver_sample(sample);
+        }
+
+        lock.lock();
+        entry->draining = false;
+        // Still non-zero: more arrived while draining and their callbacks did
+        // not queue the stream, so re-queue it behind the others.
+        if (entry->pending.fetch_sub(announced, std::memory_order_acq_rel) != announced) {
+            ready_.push_back(entry);
+            ready_cv_.notify_one();
+        }
+        idle_cv_.notify_all();
+    }
+}
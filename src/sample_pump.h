@@ -0,0 +1,59 @@
+#pragma once
+
+#include <gst/app/gstappsink.h>
+#include <gst/gst.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class RtspStream;
+
+// Fixed pool of consumer threads serving every appsink (SampleDelivery::Pool).
+//
+// Each appsink's new_sample callback only bumps a per-stream counter and, on
+// the 0 → 1 transition, queues the stream; the streaming thread never runs
+// consumer code. Workers pop ready streams round-robin, drain the samples
+// announced so far with gst_app_sink_try_pull_sample(…, 0) and re-queue the
+// stream at the back if more arrived meanwhile. A stream is owned by at most
+// one worker at a time, so its frames stay in order, and the thread count no
+// longer grows with the number of streams.
+class SamplePump {
+public:
+    explicit SamplePump(int num_threads);
+    ~SamplePump();
+
+    int num_threads() const { return (int)threads_.size(); }
+
+    // Install the wake-up callback on appsink. The pipeline must not be
+    // PLAYING yet.
+    void add(RtspStream* stream, GstAppSink* appsink);
+    // Call once the stream's pipeline has reached NULL (no more callbacks):
+    // drops the stream from the ready queue and waits out an in-flight drain.
+    void remove(RtspStream* stream);
+
+private:
+    struct Entry {
+        SamplePump*      pump     = nullptr;
+        RtspStream*      stream   = nullptr;
+        GstAppSink*      appsink  = nullptr;  // owned reference
+        std::atomic<int> pending{0};          // samples announced, not yet drained
+        bool             draining = false;    // guarded by mutex_
+    };
+
+    static GstFlowReturn on_new_sample(GstAppSink* sink, gpointer user_data);
+    void enqueue(Entry* entry);
+    void worker();
+
+    std::mutex                          mutex_;
+    std::condition_variable             ready_cv_;
+    std::condition_variable             idle_cv_;   // remove() waiting on a drain
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::deque<Entry*>                  ready_;
+    bool                                running_ = true;
+    std::vector<std::thread>            threads_;
+};
@@ -0,0 +1,107 @@
+#include "shm_util.h"
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free,
+              "futex word must be a plain lock-free 32-bit integer");
+
+// ---------------------------------------------------------------------------
+// ShmSegment
+// ---------------------------------------------------------------------------
+
+ShmSegment::~ShmSegment() { close(); }
+
+bool ShmSegment::create(const std::string& name, size_t size) {
+    close();
+    fd_ = static_cast<int>(syscall(SYS_memfd_create, name.c_str(), 0u));
+    if (fd_ < 0) {
+        std::cerr << "[ShmSegment] memfd_create failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        std::cerr << "[ShmSegment] ftruncate failed: " << std::strerror(errno) << "\n";
+        close();
+        return false;
+    }
+    data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        std::cerr << "[ShmSegment] mmap failed: " << std::strerror(errno) << "\n";
+        close();
+        return false;
+    }
+    size_ = size;
+    return true;
+}
+
+bool ShmSegment::open(const std::string& path, bool writable) {
+    close();
+    fd_ = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (fd_ < 0) {
+        std::cerr << "[ShmSegment] Cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd_, &st) != 0 || st.st_size <= 0) {
+        std::cerr << "[ShmSegment] Empty or unreadable segment: " << path << "\n";
+        close();
+        return false;
+    }
+    data_ = mmap(nullptr, static_cast<size_t>(st.st_size),
+                 writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        std::cerr << "[ShmSegment] mmap failed: " << std::strerror(errno) << "\n";
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void ShmSegment::close() {
+    if (data_) munmap(data_, size_);
+    if (fd_ >= 0) ::close(fd_);
+    data_ = nullptr;
+    size_ = 0;
+    fd_   = -1;
+}
+
+std::string ShmSegment::path() const {
+    if (fd_ < 0) return {};
+    return "/proc/" + std::to_string(getpid()) + "/fd/" + std::to_string(fd_);
+}
+
+// ---------------------------------------------------------------------------
+// Futex
+// ---------------------------------------------------------------------------
+
+bool futex_wait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts {};
+    struct timespec* tsp = nullptr;
+    if (timeout_ms >= 0) {
+        ts.tv_sec  = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+        tsp = &ts;
+    }
+    // Non-private: the word lives in memory shared with other processes.
+    const long r = syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT,
+                           expected, tsp, nullptr, 0);
+    return !(r != 0 && errno == ETIMEDOUT);
+}
+
+void futex_wake_all(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Helpers shared by the shared-memory export rings (Linux only).
+//
+// Segments are anonymous memfds. Other local processes (same user) map them
+// through /proc/<pid>/fd/<fd>, so no socket is needed to hand the fd over.
+// Cross-process wake-ups use non-private futexes on a 32-bit word inside the
+// mapping.
+
+class ShmSegment {
+public:
+    ShmSegment() = default;
+    ~ShmSegment();
+    ShmSegment(const ShmSegment&)            = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    // Create and map a new zero-filled segment.
+    bool create(const std::string& name, size_t size);
+
+    // Map an existing segment by path (e.g. "/proc/1234/fd/7"). The size is
+    // taken from the file. Readers that update waiter counts or refcounts in
+    // the mapping must open it writable.
+    bool open(const std::string& path, bool writable);
+
+    void close();
+
+    void*  data() const { return data_; }
+    size_t size() const { return size_; }
+    int    fd()   const { return fd_; }
+
+    // Path another process can pass to open() while this process is alive.
+    std::string path() const;
+
+private:
+    int    fd_   = -1;
+    void*  data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Block while *word == expected, up to timeout_ms (< 0 waits forever).
+// Returns false on timeout.
+bool futex_wait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms);
+
+// Wake every waiter on word.
+void futex_wake_all(std::atomic<uint32_t>* word);
@@ -29,10 +29,13 @@ public:
     void print_discovered_streams() const;
     std::vector<StreamInfo> get_active_streams() const;
 
+    // Single TCP connect probe (2 s timeout). Public so rtsp_bench can measure
+    // probe throughput against a local listener.
+    bool probe_rtsp_endpoint(const std::string& ip, int port = 554);
+
 private:
     void discovery_worker();
     void scan_network_range(const std::string& base_ip, int start_host, int end_host);
-    bool probe_rtsp_endpoint(const std::string& ip, int port = 554);
     void cleanup_stale_streams();
 
     mutable std::mutex streams_mutex_;
@@ -0,0 +1,175 @@
+#include "tensor_convert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TENSOR_CONVERT_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TENSOR_CONVERT_SSE2 1
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+#endif
+
+// ---------------------------------------------------------------------------
+// Affine int → float
+// ---------------------------------------------------------------------------
+
+void affine_u8_to_f32(const uint8_t* in, float* out, size_t n, float offset, float scale) {
+    size_t i = 0;
+#if defined(TENSOR_CONVERT_NEON)
+    const float32x4_t vo = vdupq_n_f32(offset);
+    const float32x4_t vs = vdupq_n_f32(scale);
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t q  = vld1q_u8(in + i);
+        const uint16x8_t lo = vmovl_u8(vget_low_u8(q));
+        const uint16x8_t hi = vmovl_u8(vget_high_u8(q));
+        vst1q_f32(out + i +  0, vmulq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))),  vo), vs));
+        vst1q_f32(out + i +  4, vmulq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), vo), vs));
+        vst1q_f32(out + i +  8, vmulq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))),  vo), vs));
+        vst1q_f32(out + i + 12, vmulq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), vo), vs));
+    }
+#elif defined(TENSOR_CONVERT_SSE2)
+    const __m128  vo   = _mm_set1_ps(offset);
+    const __m128  vs   = _mm_set1_ps(scale);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const __m128i q  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i lo = _mm_unpacklo_epi8(q, zero);
+        const __m128i hi = _mm_unpackhi_epi8(q, zero);
+        _mm_storeu_ps(out + i +  0, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), vo), vs));
+        _mm_storeu_ps(out + i +  4, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), vo), vs));
+        _mm_storeu_ps(out + i +  8, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), vo), vs));
+        _mm_storeu_ps(out + i + 12, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), vo), vs));
+    }
+#endif
+    for (; i < n; ++i) out[i] = (static_cast<float>(in[i]) - offset) * scale;
+}
+
+void affine_s8_to_f32(const int8_t* in, float* out, size_t n, float offset, float scale) {
+    size_t i = 0;
+#if defined(TENSOR_CONVERT_NEON)
+    const float32x4_t vo = vdupq_n_f32(offset);
+    const float32x4_t vs = vdupq_n_f32(scale);
+    for (; i + 16 <= n; i += 16) {
+        const int8x16_t q  = vld1q_s8(in + i);
+        const int16x8_t lo = vmovl_s8(vget_low_s8(q));
+        const int16x8_t hi = vmovl_s8(vget_high_s8(q));
+        vst1q_f32(out + i +  0, vmulq_f32(vsubq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))),  vo), vs));
+        vst1q_f32(out + i +  4, vmulq_f32(vsubq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))), vo), vs));
+        vst1q_f32(out + i +  8, vmulq_f32(vsubq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))),  vo), vs));
+        vst1q_f32(out + i + 12, vmulq_f32(vsubq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))), vo), vs));
+    }
+#elif defined(TENSOR_CONVERT_SSE2)
+    const __m128 vo = _mm_set1_ps(offset);
+    const __m128 vs = _mm_set1_ps(scale);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by duplicating each byte into the high half, then shifting down.
+        const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(q, q), 8);
+        const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(q, q), 8);
+        _mm_storeu_ps(out + i +  0, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16)), vo), vs));
+        _mm_storeu_ps(out + i +  4, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16)), vo), vs));
+        _mm_storeu_ps(out + i +  8, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16)), vo), vs));
+        _mm_storeu_ps(out + i + 12, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16)), vo), vs));
+    }
+#endif
+    for (; i < n; ++i) out[i] = (static_cast<float>(in[i]) - offset) * scale;
+}
+
+// ---------------------------------------------------------------------------
+// Pixels → int8 input tensor
+// ---------------------------------------------------------------------------
+
+void affine_u8_to_s8(const uint8_t* in, int8_t* out, size_t n, float a, float b) {
+    // Written so the compiler vectorises it (no SIMD-specific rounding mode
+    // juggling needed); lrintf rounds to nearest even like TFLite's quantizer.
+    for (size_t i = 0; i < n; ++i) {
+        const long q = std::lrintf(static_cast<float>(in[i]) * a + b);
+        out[i] = static_cast<int8_t>(std::clamp<long>(q, -128, 127));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// binary16 ↔ binary32
+// ---------------------------------------------------------------------------
+
+static float half_to_float_scalar(uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exp  = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ff;
+    uint32_t bits;
+    if (exp == 0) {
+        if (mant == 0) {
+            bits = sign;
+        } else {  // subnormal: renormalize
+            exp = 127 - 15 + 1;
+            while (!(mant & 0x400)) { mant <<= 1; --exp; }
+            bits = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+        }
+    } else if (exp == 31) {
+        bits = sign | 0x7f800000u | (mant << 13);  // inf / NaN
+    } else {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static uint16_t float_to_half_scalar(float f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    const uint16_t sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    const uint32_t fexp = (x >> 23) & 0xff;
+    uint32_t       mant = x & 0x7fffff;
+
+    if (fexp == 0xff) return sign | 0x7c00 | (mant ? 0x200 : 0);  // inf / NaN
+    const int32_t exp = static_cast<int32_t>(fexp) - 127 + 15;
+    if (exp >= 31) return sign | 0x7c00;                            // overflow → inf
+
+    if (exp <= 0) {                                                 // subnormal / zero
+        if (exp < -10) return sign;
+        mant |= 0x800000;
+        const uint32_t shift   = static_cast<uint32_t>(14 - exp);
+        uint32_t       half    = mant >> shift;
+        const uint32_t rem     = mant & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rem > halfway || (rem == halfway && (half & 1))) ++half;
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    const uint32_t rem = mant & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) ++half;      // carry may round up to inf
+    return sign | static_cast<uint16_t>(half);
+}
+
+void half_to_float(const uint16_t* in, float* out, size_t n) {
+    size_t i = 0;
+#if defined(TENSOR_CONVERT_NEON) && defined(__aarch64__)
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+#elif defined(TENSOR_CONVERT_SSE2) && defined(__F16C__)
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+#endif
+    for (; i < n; ++i) out[i] = half_to_float_scalar(in[i]);
+}
+
+void float_to_half(const float* in, uint16_t* out, size_t n) {
+    size_t i = 0;
+#if defined(TENSOR_CONVERT_NEON) && defined(__aarch64__)
+    for (; i + 4 <= n; i += 4)
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+#elif defined(TENSOR_CONVERT_SSE2) && defined(__F16C__)
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+    for (; i < n; ++i) out[i] = float_to_half_scalar(in[i]);
+}
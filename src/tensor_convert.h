@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Element-wise conversions between image bytes, quantized tensors and float.
+// Hot loops use NEON on ARM and SSE2 (plus F16C when enabled) on x86, with
+// scalar tails / fallbacks. All functions tolerate n == 0.
+
+// out[i] = (in[i] − offset) × scale
+// Dequantizes uint8 tensors (offset = zero_point) and normalizes raw pixels
+// (offset = mean, scale = 1 / std).
+void affine_u8_to_f32(const uint8_t* in, float* out, size_t n, float offset, float scale);
+
+// out[i] = (in[i] − offset) × scale, signed input (int8 dequantization).
+void affine_s8_to_f32(const int8_t* in, float* out, size_t n, float offset, float scale);
+
+// out[i] = clamp(round(in[i] × a + b), −128, 127)
+// Pixels straight into an int8 input tensor: a = 1 / (std × scale),
+// b = zero_point − mean × a.
+void affine_u8_to_s8(const uint8_t* in, int8_t* out, size_t n, float a, float b);
+
+// IEEE 754 binary16 ↔ binary32.
+void half_to_float(const uint16_t* in, float* out, size_t n);
+void float_to_half(const float* in, uint16_t* out, size_t n);
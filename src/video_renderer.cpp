@@ -4,12 +4,27 @@
 #define GLFW_INCLUDE_GLCOREARB
 #include <GLFW/glfw3.h>
 
+#ifdef RTSP_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 #include "video_renderer.h"
+#include "frame_consumer.h"
+#include "spsc_queue.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 // ---------------------------------------------------------------------------
@@ -37,6 +52,23 @@ void main() {
 }
 )";
 
+// NV12 DMABuf frames: Y and interleaved UV planes imported as separate R8 /
+// RG88 textures, converted with BT.601 limited-range coefficients.
+static const char* kNv12FragmentShader = R"(
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+uniform sampler2D tex_y;
+uniform sampler2D tex_uv;
+void main() {
+    float y  = 1.164 * (texture(tex_y, TexCoord).r - 0.0625);
+    vec2  uv = texture(tex_uv, TexCoord).rg - 0.5;
+    FragColor = vec4(y + 1.596 * uv.y,
+                     y - 0.391 * uv.x - 0.813 * uv.y,
+                     y + 2.018 * uv.x, 1.0);
+}
+)";
+
 // Fullscreen quad: xy + uv. V-axis flipped (image top-left → GL bottom-left).
 static const float kQuadVertices[] = {
     -1.0f, -1.0f,   0.0f, 1.0f,
@@ -47,41 +79,263 @@ static const float kQuadVertices[] = {
 static const unsigned int kQuadIndices[] = { 0, 1, 2,  0, 2, 3 };
 
 // ---------------------------------------------------------------------------
-// Per-stream slot (each has its own texture + pending-frame buffer + mutex)
+// Per-stream slot (each has its own textures + frame queue + mutex)
 // std::mutex is not movable, so slots live on the heap via unique_ptr.
 // ---------------------------------------------------------------------------
 
+// What a slot currently displays.
+enum class SlotContent {
+    Empty,
+    Rgb,         // tex[front], uploaded from CPU memory
+    DmabufRgb,   // plane_tex[0], imported RGBx-family DMABuf
+    DmabufNv12,  // plane_tex[0..1], imported NV12 DMABuf
+    Shared,      // shown_texture, from a context sharing ours
+};
+
+static int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A frame waiting in a slot's presentation queue. `kind` says which payload
+// is set.
+struct QueuedFrame {
+    enum class Kind { Rgb, Dmabuf, Texture };
+    Kind                 kind       = Kind::Rgb;
+    std::vector<uint8_t> rgb;
+    int                  width      = 0;
+    int                  height     = 0;
+    int                  row_pixels = 0;  // GL_UNPACK_ROW_LENGTH of rgb
+    DmabufFrame          dmabuf;
+    GlTextureFrame       texture;
+    int64_t              present_ns = 0;  // steady clock; 0: as soon as possible
+};
+
+// glTexStorage2D: core in GL 4.2, ARB_texture_storage on older contexts.
+typedef void (*GlTexStorage2D)(GLenum target, GLsizei levels, GLenum internal_format,
+                               GLsizei width, GLsizei height);
+
+// Frames queued per slot: the latency target's worth at the stream's frame
+// interval plus slack, within these bounds; beyond that the oldest is
+// dropped. The upper bound covers VideoRenderer::kMaxPresentLatencyMs at 60 fps.
+static constexpr size_t  kMinQueuedFrames = 8;
+static constexpr size_t  kMaxQueuedFrames = 64;
+// A PTS this far off the slot's clock mapping is a discontinuity (seek, file
+// loop, reconnect): the mapping restarts instead of holding frames back.
+static constexpr int64_t kClockResyncNs   = 1000000000;
+
 struct StreamSlot {
-    GLuint texture    = 0;
-    int    tex_width  = 0;
-    int    tex_height = 0;
-
-    std::mutex           mutex;
-    std::vector<uint8_t> pending_frame;
-    int                  pending_width  = 0;
-    int                  pending_height = 0;
-    bool                 frame_dirty    = false;
+    // CPU uploads alternate between two textures: each frame goes into the
+    // one not on screen, once the GPU has finished the draws sampling it, so
+    // an upload never waits on (or is serialised behind) an earlier draw.
+    GLuint tex[2]        = {0, 0};
+    int    tex_width[2]  = {0, 0};              // storage size; 0: none yet
+    int    tex_height[2] = {0, 0};
+    GLsync tex_free[2]   = {nullptr, nullptr};  // signals after the last draw sampling tex[i]
+    int    front         = 0;
+    SlotContent content = SlotContent::Empty;
+
+    std::mutex                        mutex;
+    std::deque<QueuedFrame>           queue;      // ordered by present_ns
+    std::vector<std::vector<uint8_t>> spare_rgb;  // recycled QueuedFrame::rgb buffers
+    // PTS → steady clock: the smallest (arrival − PTS) seen, i.e. the delay of
+    // the least-delayed frame, creeping up slowly to follow sender clock drift.
+    bool                              clock_valid     = false;
+    int64_t                           clock_offset_ns = 0;
+    int64_t                           last_pts_ns       = -1;
+    int64_t                           frame_interval_ns = 0;  // EMA of PTS spacing; sizes the queue
+
+    // Render thread only: swapped with the shown frame's buffer, so buffers
+    // keep their capacity and a frame is never copied twice.
+    std::vector<uint8_t> upload_frame;
+
+    // Render thread only: the imported DMABuf frame on screen. `shown_dmabuf`
+    // keeps its buffer alive while the textures sample it, and afterwards
+    // until the last draw that did has finished (see RetiredFrame).
+    GLuint               plane_tex[DmabufFrame::kMaxPlanes] = {0, 0};
+    void*                images[DmabufFrame::kMaxPlanes]    = {nullptr, nullptr};  // EGLImageKHR
+    DmabufFrame          shown_dmabuf;
+    GlTextureFrame       shown_texture;
+
+};
+
+// A DMABuf or shared-texture frame taken off screen. Draws that sampled it
+// may still be executing, so its buffer only goes back to the decoder (or
+// GStreamer GL) pool once a fence placed after them has signalled.
+struct RetiredFrame {
+    DmabufFrame           dmabuf;
+    std::shared_ptr<void> keepalive;  // GlTextureFrame::keepalive
+    void*                 images[DmabufFrame::kMaxPlanes] = {nullptr, nullptr};  // EGLImageKHR
+};
+
+struct RetiredBatch {
+    GLsync                    fence = nullptr;
+    std::vector<RetiredFrame> frames;
+};
+
+// ---------------------------------------------------------------------------
+// EGL DMABuf import
+// ---------------------------------------------------------------------------
+
+#ifdef RTSP_HAVE_EGL
+// GL_OES_EGL_image entry point; the typedef lives in the GLES headers.
+typedef void (APIENTRYP GlEglImageTargetTexture2D)(GLenum target, void* image);
+
+struct EglImporter {
+    EGLDisplay                display        = EGL_NO_DISPLAY;
+    PFNEGLCREATEIMAGEKHRPROC  create_image   = nullptr;
+    PFNEGLDESTROYIMAGEKHRPROC destroy_image  = nullptr;
+    GlEglImageTargetTexture2D target_texture = nullptr;
+
+    // Context must be current. False unless it is an EGL context whose
+    // display supports EGL_EXT_image_dma_buf_import.
+    bool init() {
+        display = eglGetCurrentDisplay();
+        if (display == EGL_NO_DISPLAY) return false;
+        const char* ext = eglQueryString(display, EGL_EXTENSIONS);
+        if (!ext || !std::strstr(ext, "EGL_EXT_image_dma_buf_import")) return false;
+        create_image   = reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(eglGetProcAddress("eglCreateImageKHR"));
+        destroy_image  = reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(eglGetProcAddress("eglDestroyImageKHR"));
+        target_texture = reinterpret_cast<GlEglImageTargetTexture2D>(eglGetProcAddress("glEGLImageTargetTexture2DOES"));
+        return create_image && destroy_image && target_texture;
+    }
+
+    EGLImageKHR import_plane(int fd, uint32_t offset, uint32_t stride,
+                             int width, int height, uint32_t fourcc) const {
+        const EGLint attrs[] = {
+            EGL_WIDTH,                     width,
+            EGL_HEIGHT,                    height,
+            EGL_LINUX_DRM_FOURCC_EXT,      static_cast<EGLint>(fourcc),
+            EGL_DMA_BUF_PLANE0_FD_EXT,     fd,
+            EGL_DMA_BUF_PLANE0_OFFSET_EXT, static_cast<EGLint>(offset),
+            EGL_DMA_BUF_PLANE0_PITCH_EXT,  static_cast<EGLint>(stride),
+            EGL_NONE,
+        };
+        return create_image(display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attrs);
+    }
 };
+#endif
 
 // ---------------------------------------------------------------------------
 // Implementation struct
 // ---------------------------------------------------------------------------
 
+// One GLFW window: a grid over a subset of the slots. Its context shares
+// textures, buffers and programs with windows[0]; only the VAO (a container
+// object, never shared) is its own.
+struct RenderWindow {
+    VideoRendererImpl* owner  = nullptr;  // for GLFW callbacks
+    int                 index  = 0;
+    GLFWwindow*         window = nullptr;
+    GLuint              vao    = 0;
+    std::vector<int>    slots;  // cell i shows slots[i]
+
+    // Grid dimensions computed from the window's slot count
+    int grid_cols = 1;
+    int grid_rows = 1;
+    // Written by the framebuffer-size callback on the main thread: GLFW
+    // only allows querying it there.
+    std::atomic<int> fb_width{0};
+    std::atomic<int> fb_height{0};
+
+    GLsync drawn = nullptr;  // secondary windows: fence after last frame's draws
+
+    void set_grid(int cols);
+};
+
+// Main thread → render thread. Applied at the start of the next frame, so
+// layout changes land between frames.
+struct RenderCommand {
+    enum class Type { SetColumns, ClearSlot, SetFocus, FocusAt, Task };
+    Type                  type   = Type::Task;
+    int                   window = 0;
+    int                   value  = 0;      // columns or slot
+    float                 x = 0, y = 0;    // FocusAt: position in the window, 0..1 from top-left
+    std::function<void()> task;
+};
+
+// CPU → GL uploads left this frame. The first upload always goes through,
+// so every frame makes progress whatever the budget.
+struct UploadBudget {
+    int64_t deadline_ns = 0;  // 0: no time limit
+    int64_t bytes_left  = 0;  // < 0: no byte limit
+    bool    used        = false;
+
+    bool allows(size_t bytes) const {
+        if (!used) return true;
+        if (deadline_ns && steady_now_ns() >= deadline_ns) return false;
+        return bytes_left < 0 || static_cast<int64_t>(bytes) <= bytes_left;
+    }
+    void charge(size_t bytes) {
+        used = true;
+        if (bytes_left >= 0) bytes_left = std::max<int64_t>(0, bytes_left - static_cast<int64_t>(bytes));
+    }
+};
+
 struct VideoRendererImpl {
-    GLFWwindow* window         = nullptr;
     GLuint      shader_program = 0;
-    GLuint      vao            = 0;
+    GLuint      nv12_program   = 0;
     GLuint      vbo            = 0;
     GLuint      ebo            = 0;
 
-    std::vector<std::unique_ptr<StreamSlot>> slots;
+    std::vector<std::unique_ptr<StreamSlot>>   slots;
+    std::vector<std::unique_ptr<RenderWindow>> windows;  // [0]: primary, owns the shared objects
+    bool egl_api = false;  // windows[0] got an EGL context; sharing needs the same API
+    GlTexStorage2D tex_storage = nullptr;  // null: mutable glTexImage2D storage
 
-    // Grid dimensions computed from slot count
-    int grid_cols = 1;
-    int grid_rows = 1;
+    // Cleared for good after the first failed import: streams then map frames.
+    std::atomic<bool> dmabuf_ok{false};
+    std::atomic<int64_t> present_latency_ns{0};  // set_present_latency_ms()
+#ifdef RTSP_HAVE_EGL
+    EglImporter egl;
+    EGLContext  egl_context = EGL_NO_CONTEXT;  // ours, for share_handles()
+#endif
+
+    // Render thread (render_thread_running) or else the main thread owns the
+    // GL context; the other side only talks to it through `commands`.
+    SpscQueue<RenderCommand, 64> commands;
+    std::thread                  render_thread;
+    std::atomic<bool>            render_thread_running{false};
+    std::atomic<double>          frame_period_ms{0.0};  // EMA, render-loop iteration
+    int64_t                      last_frame_ns = 0;
+
+    // Upload budget (set_upload_budget) and who goes first under it.
+    std::atomic<int64_t>         upload_budget_ns{8000000};
+    std::atomic<int64_t>         upload_budget_bytes{-1};
+    int                          upload_cursor = 0;   // first slot deferred last frame
+    int                          focused_slot  = -1;
+    std::atomic<uint64_t>        uploads_deferred{0};
+
+    // Render thread: frames off screen, not yet fenced / awaiting their fence.
+    std::vector<RetiredFrame>    retiring;
+    std::deque<RetiredBatch>     retired;
+
+    void post(RenderCommand&& cmd);
+    void apply(RenderCommand& cmd);
+    void render_frame();
+    void render_loop();
+    void clear(StreamSlot& s);
+
+    void open_window(const WindowSpec& spec);
+    GLuint create_vao();
+    // Primary context. False if the slot's frame was deferred for lack of budget.
+    bool update_slot(StreamSlot& s, int64_t now_ns, UploadBudget& budget);
+    void upload_rgb(StreamSlot& s, const QueuedFrame& frame);
+    void draw_window(RenderWindow& w);
+    // Slot mutex held. Queues a frame due at its PTS + latency target and
+    // returns it for the caller to fill.
+    QueuedFrame& enqueue(StreamSlot& s, QueuedFrame::Kind kind, int64_t pts_ns);
+    size_t queue_capacity(const StreamSlot& s) const;  // slot mutex held
+    int64_t present_time(StreamSlot& s, int64_t pts_ns, int64_t now_ns);
+    void recycle(StreamSlot& s, QueuedFrame& frame);
+    bool show_dmabuf(StreamSlot& s, DmabufFrame&& frame);
+    void show_texture(StreamSlot& s, GlTextureFrame&& frame);
+    void release_external(StreamSlot& s);  // imported or shared frame on screen
+    void fence_retired();
+    void reap_retired(bool all);
 
     void init_shaders();
-    void init_quad();
+    void init_buffers();
     void init_textures();
 };
 
@@ -103,67 +357,257 @@ static GLuint compile_shader(GLenum type, const char* src) {
     return shader;
 }
 
-void VideoRendererImpl::init_shaders() {
-    GLuint vert = compile_shader(GL_VERTEX_SHADER,   kVertexShader);
-    GLuint frag = compile_shader(GL_FRAGMENT_SHADER, kFragmentShader);
-    shader_program = glCreateProgram();
-    glAttachShader(shader_program, vert);
-    glAttachShader(shader_program, frag);
-    glLinkProgram(shader_program);
+static GLuint link_program(const char* vertex_src, const char* fragment_src) {
+    GLuint vert = compile_shader(GL_VERTEX_SHADER,   vertex_src);
+    GLuint frag = compile_shader(GL_FRAGMENT_SHADER, fragment_src);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vert);
+    glAttachShader(program, frag);
+    glLinkProgram(program);
     GLint ok = 0;
-    glGetProgramiv(shader_program, GL_LINK_STATUS, &ok);
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
     if (!ok) {
         char log[512];
-        glGetProgramInfoLog(shader_program, sizeof(log), nullptr, log);
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
         std::cerr << "Shader link error: " << log << "\n";
     }
     glDeleteShader(vert);
     glDeleteShader(frag);
+    return program;
 }
 
-void VideoRendererImpl::init_quad() {
-    glGenVertexArrays(1, &vao);
+void VideoRendererImpl::init_shaders() {
+    shader_program = link_program(kVertexShader, kFragmentShader);
+    nv12_program   = link_program(kVertexShader, kNv12FragmentShader);
+    glUseProgram(nv12_program);
+    glUniform1i(glGetUniformLocation(nv12_program, "tex_y"),  0);
+    glUniform1i(glGetUniformLocation(nv12_program, "tex_uv"), 1);
+    glUseProgram(0);
+}
+
+void VideoRendererImpl::init_buffers() {
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
-    glBindVertexArray(vao);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(kQuadVertices), kQuadVertices, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(kQuadIndices), kQuadIndices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Current context: the window's own. Binds the shared quad buffers.
+GLuint VideoRendererImpl::create_vao() {
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return vao;
+}
+
+void RenderWindow::set_grid(int cols) {
+    const int n = std::max((int)slots.size(), 1);
+    grid_cols = std::max(1, std::min(cols, n));
+    grid_rows = std::max(1, (int)std::ceil((double)n / grid_cols));
+}
+
+static GLuint create_texture() {
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return tex;
 }
 
 void VideoRendererImpl::init_textures() {
-    for (auto& slot : slots) {
-        glGenTextures(1, &slot->texture);
-        glBindTexture(GL_TEXTURE_2D, slot->texture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    }
+    // Immutable storage spares the driver from revalidating the texture on
+    // every upload; a size change allocates a new one instead.
+    if (glfwExtensionSupported("GL_ARB_texture_storage"))
+        tex_storage = reinterpret_cast<GlTexStorage2D>(glfwGetProcAddress("glTexStorage2D"));
+    for (auto& slot : slots)
+        for (GLuint& tex : slot->tex) tex = create_texture();
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+// ---------------------------------------------------------------------------
+// Presentation queue
+// ---------------------------------------------------------------------------
+
+int64_t VideoRendererImpl::present_time(StreamSlot& s, int64_t pts_ns, int64_t now_ns) {
+    const int64_t latency = present_latency_ns.load(std::memory_order_relaxed);
+    if (latency <= 0 || pts_ns < 0) return 0;
+
+    const int64_t offset = now_ns - pts_ns;
+    if (!s.clock_valid || std::llabs(offset - s.clock_offset_ns) > kClockResyncNs) {
+        s.clock_offset_ns = offset;
+        s.clock_valid     = true;
+    } else if (offset < s.clock_offset_ns) {
+        s.clock_offset_ns = offset;
+    } else {
+        s.clock_offset_ns += (offset - s.clock_offset_ns) / 4096;
+    }
+    // Frames delayed by more than the target are late: due at once.
+    return pts_ns + s.clock_offset_ns + latency;
+}
+
+size_t VideoRendererImpl::queue_capacity(const StreamSlot& s) const {
+    const int64_t latency = present_latency_ns.load(std::memory_order_relaxed);
+    if (latency <= 0 || s.frame_interval_ns <= 0) return kMinQueuedFrames;
+    const size_t frames = static_cast<size_t>(latency / s.frame_interval_ns) + 4;
+    return std::clamp(frames, kMinQueuedFrames, kMaxQueuedFrames);
+}
+
+QueuedFrame& VideoRendererImpl::enqueue(StreamSlot& s, QueuedFrame::Kind kind, int64_t pts_ns) {
+    if (pts_ns >= 0) {
+        const int64_t delta = pts_ns - s.last_pts_ns;
+        if (s.last_pts_ns >= 0 && delta > 0 && delta < kClockResyncNs)
+            s.frame_interval_ns = s.frame_interval_ns ? s.frame_interval_ns + (delta - s.frame_interval_ns) / 8
+                                                      : delta;
+        s.last_pts_ns = pts_ns;
+    }
+    while (s.queue.size() >= queue_capacity(s)) {
+        recycle(s, s.queue.front());
+        s.queue.pop_front();
+    }
+    QueuedFrame frame;
+    frame.kind       = kind;
+    frame.present_ns = present_time(s, pts_ns, steady_now_ns());
+    if (kind == QueuedFrame::Kind::Rgb && !s.spare_rgb.empty()) {
+        frame.rgb = std::move(s.spare_rgb.back());
+        s.spare_rgb.pop_back();
+    }
+    auto pos = std::upper_bound(s.queue.begin(), s.queue.end(), frame.present_ns,
+                                [](int64_t t, const QueuedFrame& f) { return t < f.present_ns; });
+    return *s.queue.insert(pos, std::move(frame));
+}
+
+// An unshown texture frame was never waited on or drawn: dropping it needs
+// no `done`.
+void VideoRendererImpl::recycle(StreamSlot& s, QueuedFrame& frame) {
+    if (frame.rgb.capacity() && s.spare_rgb.size() < kMinQueuedFrames)
+        s.spare_rgb.push_back(std::move(frame.rgb));
+    frame.dmabuf  = DmabufFrame{};
+    frame.texture = GlTextureFrame{};
+}
+
+// Render thread. Imports every plane first so a failure leaves the slot
+// showing its previous content.
+bool VideoRendererImpl::show_dmabuf(StreamSlot& s, DmabufFrame&& frame) {
+#ifdef RTSP_HAVE_EGL
+    const bool nv12 = frame.drm_format == kDrmFormatNV12;
+    if (frame.num_planes != (nv12 ? 2 : 1)) return false;
+
+    EGLImageKHR images[DmabufFrame::kMaxPlanes] = {EGL_NO_IMAGE_KHR, EGL_NO_IMAGE_KHR};
+    for (int p = 0; p < frame.num_planes; ++p) {
+        // NV12 is imported plane by plane (R8 luma, GR88 chroma) so plain
+        // sampler2D works without GL_OES_EGL_image_external.
+        const uint32_t fourcc = !nv12 ? frame.drm_format
+                                      : (p == 0 ? drm_fourcc('R', '8', ' ', ' ') : drm_fourcc('G', 'R', '8', '8'));
+        const int w = (nv12 && p == 1) ? (frame.width + 1) / 2 : frame.width;
+        const int h = (nv12 && p == 1) ? (frame.height + 1) / 2 : frame.height;
+        images[p] = egl.import_plane(frame.fd[p], frame.offset[p], frame.stride[p], w, h, fourcc);
+        if (images[p] == EGL_NO_IMAGE_KHR) {
+            for (int q = 0; q < p; ++q) egl.destroy_image(egl.display, images[q]);
+            if (dmabuf_ok.exchange(false))
+                std::cerr << "[VideoRenderer] DMABuf import failed (EGL error 0x" << std::hex
+                          << eglGetError() << std::dec << "); falling back to mapped frames\n";
+            return false;
+        }
+    }
+
+    release_external(s);
+    for (int p = 0; p < frame.num_planes; ++p) {
+        if (!s.plane_tex[p]) s.plane_tex[p] = create_texture();
+        glBindTexture(GL_TEXTURE_2D, s.plane_tex[p]);
+        egl.target_texture(GL_TEXTURE_2D, images[p]);
+        s.images[p] = images[p];
+    }
+    s.content      = nv12 ? SlotContent::DmabufNv12 : SlotContent::DmabufRgb;
+    s.shown_dmabuf = std::move(frame);
+    return true;
+#else
+    (void)s;
+    (void)frame;
+    return false;
+#endif
+}
+
+void VideoRendererImpl::show_texture(StreamSlot& s, GlTextureFrame&& frame) {
+    if (frame.wait) frame.wait();
+    release_external(s);
+    s.shown_texture = std::move(frame);
+    s.content       = SlotContent::Shared;
+}
+
+void VideoRendererImpl::release_external(StreamSlot& s) {
+    RetiredFrame old;
+    for (int p = 0; p < DmabufFrame::kMaxPlanes; ++p) {
+        old.images[p] = s.images[p];
+        s.images[p]   = nullptr;
+    }
+    old.dmabuf = std::move(s.shown_dmabuf);
+    s.shown_dmabuf = DmabufFrame{};
+    if (s.shown_texture.done) s.shown_texture.done();  // GPU-side sync point after our draws
+    old.keepalive   = std::move(s.shown_texture.keepalive);
+    s.shown_texture = GlTextureFrame{};
+    if (old.dmabuf.keepalive || old.keepalive || old.images[0] || old.images[1])
+        retiring.push_back(std::move(old));
+    if (s.content != SlotContent::Rgb) s.content = SlotContent::Empty;
+}
+
+// Primary context, after render_frame() has waited for the other windows'
+// draws: everything retired so far was last sampled before this point.
+void VideoRendererImpl::fence_retired() {
+    if (retiring.empty()) return;
+    RetiredBatch batch;
+    batch.fence  = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    batch.frames = std::move(retiring);
+    retiring.clear();
+    retired.push_back(std::move(batch));
+}
+
+// Drops retired frames whose fence has signalled (all: the caller has made
+// sure the GPU is idle). Fences signal in order, so the scan stops early.
+void VideoRendererImpl::reap_retired(bool all) {
+    while (!retired.empty()) {
+        RetiredBatch& batch = retired.front();
+        if (!all && glClientWaitSync(batch.fence, 0, 0) == GL_TIMEOUT_EXPIRED) break;
+        glDeleteSync(batch.fence);
+#ifdef RTSP_HAVE_EGL
+        for (RetiredFrame& f : batch.frames)
+            for (void* image : f.images)
+                if (image) egl.destroy_image(egl.display, image);
+#endif
+        retired.pop_front();
+    }
+    if (all) retiring.clear();
+}
+
 // ---------------------------------------------------------------------------
 // VideoRenderer
 // ---------------------------------------------------------------------------
 
-VideoRenderer::VideoRenderer(int num_streams, const std::string& title)
+VideoRenderer::VideoRenderer(int num_streams, const std::string& title,
+                             int columns, int window_width, int window_height)
+    : VideoRenderer(num_streams, std::vector<WindowSpec>{
+                                     WindowSpec{title, columns, window_width, window_height, -1, {}}}) {}
+
+VideoRenderer::VideoRenderer(int num_streams, const std::vector<WindowSpec>& windows)
     : impl_(std::make_unique<VideoRendererImpl>())
 {
     // Build per-stream slots
     for (int i = 0; i < num_streams; ++i)
         impl_->slots.push_back(std::make_unique<StreamSlot>());
 
-    // Grid: prefer wider layout (more cols than rows)
-    impl_->grid_cols = (int)std::ceil(std::sqrt((double)num_streams));
-    impl_->grid_rows = (int)std::ceil((double)num_streams / impl_->grid_cols);
-
     if (!glfwInit())
         throw std::runtime_error("Failed to initialize GLFW");
 
@@ -171,94 +615,469 @@ VideoRenderer::VideoRenderer(int num_streams, const std::string& title)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_AUTO_ICONIFY, GLFW_FALSE);  // fullscreen walls stay up without focus
 
-    impl_->window = glfwCreateWindow(1280, 720, title.c_str(), nullptr, nullptr);
-    if (!impl_->window) {
-        glfwTerminate();
-        throw std::runtime_error("Failed to create GLFW window");
+    for (const WindowSpec& spec : windows.empty() ? std::vector<WindowSpec>{WindowSpec{}} : windows) {
+        try {
+            impl_->open_window(spec);
+        } catch (...) {
+            for (auto& w : impl_->windows) glfwDestroyWindow(w->window);
+            glfwTerminate();
+            throw;
+        }
+        if (impl_->windows.size() == 1) {
+            // Objects every window shares live in the primary context.
+            impl_->init_shaders();
+            impl_->init_buffers();
+            impl_->init_textures();
+        }
+        RenderWindow& w = *impl_->windows.back();
+        w.vao = impl_->create_vao();
     }
+    glfwMakeContextCurrent(impl_->windows[0]->window);
 
-    glfwMakeContextCurrent(impl_->window);
-    glfwSwapInterval(1);
+#ifdef RTSP_HAVE_EGL
+    impl_->dmabuf_ok   = impl_->egl.init();
+    impl_->egl_context = eglGetCurrentContext();
+#endif
+    std::cout << "[VideoRenderer] " << impl_->windows.size() << " window(s); DMABuf import "
+              << (impl_->dmabuf_ok ? "enabled" : "unavailable; frames are uploaded from CPU memory") << "\n";
+}
 
-    impl_->init_shaders();
-    impl_->init_quad();
-    impl_->init_textures();
+// Leaves the new window's context current.
+void VideoRendererImpl::open_window(const WindowSpec& spec) {
+    auto w = std::make_unique<RenderWindow>();
+    const int n = (int)slots.size();
+    if (spec.slots.empty()) {
+        for (int i = 0; i < n; ++i) w->slots.push_back(i);
+    } else {
+        for (int slot : spec.slots) {
+            if (slot >= 0 && slot < n) w->slots.push_back(slot);
+            else std::cerr << "[VideoRenderer] Window \"" << spec.title << "\": no slot " << slot << "\n";
+        }
+    }
+    w->set_grid(spec.columns > 0 ? spec.columns : (int)std::ceil(std::sqrt((double)w->slots.size())));
+
+    // Fullscreen on the requested monitor, at its current mode.
+    GLFWmonitor* monitor = nullptr;
+    int width = spec.width, height = spec.height;
+    if (spec.monitor >= 0) {
+        int count = 0;
+        GLFWmonitor** monitors = glfwGetMonitors(&count);
+        if (spec.monitor < count) {
+            monitor = monitors[spec.monitor];
+            const GLFWvidmode* mode = glfwGetVideoMode(monitor);
+            width  = mode->width;
+            height = mode->height;
+        } else {
+            std::cerr << "[VideoRenderer] No monitor " << spec.monitor << "; opening a window instead\n";
+        }
+    }
+
+    GLFWwindow* share = windows.empty() ? nullptr : windows[0]->window;
+#ifdef RTSP_HAVE_EGL
+    // Prefer an EGL context: DMABuf frames can only be imported through EGL.
+    // Contexts that share must come from the same API as the primary one.
+    if (windows.empty() || egl_api) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        w->window = glfwCreateWindow(width, height, spec.title.c_str(), monitor, share);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+        if (windows.empty()) egl_api = w->window != nullptr;
+    }
+#endif
+    if (!w->window && !egl_api)
+        w->window = glfwCreateWindow(width, height, spec.title.c_str(), monitor, share);
+    if (!w->window)
+        throw std::runtime_error("Failed to create GLFW window");
+
+    int fb_w = 0, fb_h = 0;
+    glfwGetFramebufferSize(w->window, &fb_w, &fb_h);
+    w->fb_width  = fb_w;
+    w->fb_height = fb_h;
+    w->owner = this;
+    w->index = (int)windows.size();
+    glfwSetWindowUserPointer(w->window, w.get());
+    glfwSetMouseButtonCallback(w->window, [](GLFWwindow* window, int button, int action, int) {
+        if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) return;
+        auto* self = static_cast<RenderWindow*>(glfwGetWindowUserPointer(window));
+        double cx = 0, cy = 0;
+        int    width = 0, height = 0;
+        glfwGetCursorPos(window, &cx, &cy);
+        glfwGetWindowSize(window, &width, &height);
+        if (width <= 0 || height <= 0) return;
+        RenderCommand cmd;
+        cmd.type   = RenderCommand::Type::FocusAt;
+        cmd.window = self->index;
+        cmd.x      = static_cast<float>(cx / width);
+        cmd.y      = static_cast<float>(cy / height);
+        self->owner->post(std::move(cmd));
+    });
+    glfwSetFramebufferSizeCallback(w->window, [](GLFWwindow* window, int width, int height) {
+        auto* self = static_cast<RenderWindow*>(glfwGetWindowUserPointer(window));
+        self->fb_width.store(width, std::memory_order_relaxed);
+        self->fb_height.store(height, std::memory_order_relaxed);
+    });
+
+    glfwMakeContextCurrent(w->window);
+    // Only the primary window waits for vblank: one render() presents every
+    // window, and each extra wait would divide the frame rate.
+    glfwSwapInterval(windows.empty() ? 1 : 0);
+    windows.push_back(std::move(w));
 }
 
 VideoRenderer::~VideoRenderer() {
-    for (auto& slot : impl_->slots)
-        if (slot->texture) glDeleteTextures(1, &slot->texture);
-    if (impl_->vao)            glDeleteVertexArrays(1, &impl_->vao);
+    stop_render_thread();
+    // Per-window objects first, each in its own context.
+    for (size_t i = impl_->windows.size(); i-- > 0;) {
+        RenderWindow& w = *impl_->windows[i];
+        glfwMakeContextCurrent(w.window);
+        if (w.drawn) glDeleteSync(w.drawn);
+        if (w.vao)   glDeleteVertexArrays(1, &w.vao);
+        if (i > 0)   glfwDestroyWindow(w.window);
+    }
+    glFinish();  // nothing below is still being sampled
+    for (auto& slot : impl_->slots) {
+        impl_->release_external(*slot);
+        slot->queue.clear();
+        for (int i = 0; i < 2; ++i) {
+            if (slot->tex_free[i]) glDeleteSync(slot->tex_free[i]);
+            if (slot->tex[i])      glDeleteTextures(1, &slot->tex[i]);
+        }
+        for (GLuint tex : slot->plane_tex)
+            if (tex) glDeleteTextures(1, &tex);
+    }
+    impl_->fence_retired();
+    impl_->reap_retired(true);
     if (impl_->vbo)            glDeleteBuffers(1, &impl_->vbo);
     if (impl_->ebo)            glDeleteBuffers(1, &impl_->ebo);
     if (impl_->shader_program) glDeleteProgram(impl_->shader_program);
-    if (impl_->window)         glfwDestroyWindow(impl_->window);
+    if (impl_->nv12_program)   glDeleteProgram(impl_->nv12_program);
+    glfwDestroyWindow(impl_->windows[0]->window);
     glfwTerminate();
 }
 
-void VideoRenderer::push_frame(int slot, const uint8_t* data, int width, int height) {
+void VideoRenderer::push_frame(int slot, const uint8_t* data, int width, int height, int stride,
+                               int64_t pts_ns) {
     if (slot < 0 || slot >= (int)impl_->slots.size()) return;
     auto& s = *impl_->slots[slot];
+    const size_t row = static_cast<size_t>(width) * 3;
+    if (stride <= 0) stride = (int)row;
+
     std::lock_guard<std::mutex> lock(s.mutex);
-    s.pending_frame.assign(data, data + width * height * 3);
-    s.pending_width  = width;
-    s.pending_height = height;
-    s.frame_dirty    = true;
+    QueuedFrame& f = impl_->enqueue(s, QueuedFrame::Kind::Rgb, pts_ns);
+    if (stride % 3 == 0) {
+        // Whole-pixel padding: keep it and let GL skip it via GL_UNPACK_ROW_LENGTH.
+        f.rgb.assign(data, data + static_cast<size_t>(stride) * (height - 1) + row);
+        f.row_pixels = stride / 3;
+    } else {
+        f.rgb.resize(row * height);
+        copy_packed_rgb(f.rgb.data(), data, width, height, stride);
+        f.row_pixels = width;
+    }
+    f.width  = width;
+    f.height = height;
+}
+
+bool VideoRenderer::accepts_dmabuf() const {
+    return impl_->dmabuf_ok.load(std::memory_order_relaxed);
+}
+
+bool VideoRenderer::push_dmabuf(int slot, DmabufFrame frame, int64_t pts_ns) {
+    if (slot < 0 || slot >= (int)impl_->slots.size() || !accepts_dmabuf()) return false;
+    auto& s = *impl_->slots[slot];
+    std::lock_guard<std::mutex> lock(s.mutex);
+    impl_->enqueue(s, QueuedFrame::Kind::Dmabuf, pts_ns).dmabuf = std::move(frame);
+    return true;
+}
+
+GlShareHandles VideoRenderer::share_handles() const {
+    GlShareHandles h;
+#ifdef RTSP_HAVE_EGL
+    if (impl_->egl.display != EGL_NO_DISPLAY) {
+        h.egl_display = impl_->egl.display;
+        h.egl_context = impl_->egl_context;
+    }
+#endif
+    return h;
+}
+
+bool VideoRenderer::push_texture(int slot, GlTextureFrame frame, int64_t pts_ns) {
+    if (slot < 0 || slot >= (int)impl_->slots.size()) return false;
+    auto& s = *impl_->slots[slot];
+    std::lock_guard<std::mutex> lock(s.mutex);
+    impl_->enqueue(s, QueuedFrame::Kind::Texture, pts_ns).texture = std::move(frame);
+    return true;
+}
+
+void VideoRenderer::set_present_latency_ms(int ms) {
+    if (ms > kMaxPresentLatencyMs) {
+        std::cerr << "[VideoRenderer] Present latency " << ms << " ms capped at "
+                  << kMaxPresentLatencyMs << " ms\n";
+        ms = kMaxPresentLatencyMs;
+    }
+    impl_->present_latency_ns.store(std::max(ms, 0) * int64_t(1000000), std::memory_order_relaxed);
+}
+
+int VideoRenderer::slot_count() const {
+    return (int)impl_->slots.size();
+}
+
+void VideoRenderer::set_columns(int columns, int window) {
+    if (columns <= 0 || window < 0 || window >= window_count()) return;
+    RenderCommand cmd;
+    cmd.type   = RenderCommand::Type::SetColumns;
+    cmd.window = window;
+    cmd.value  = columns;
+    impl_->post(std::move(cmd));
+}
+
+int VideoRenderer::window_count() const {
+    return (int)impl_->windows.size();
+}
+
+void VideoRenderer::clear_slot(int slot) {
+    if (slot < 0 || slot >= (int)impl_->slots.size()) return;
+    RenderCommand cmd;
+    cmd.type  = RenderCommand::Type::ClearSlot;
+    cmd.value = slot;
+    impl_->post(std::move(cmd));
+}
+
+void VideoRenderer::run_in_context(std::function<void()> fn) {
+    if (!impl_->render_thread_running) {
+        fn();
+        return;
+    }
+    std::packaged_task<void()> task(std::move(fn));
+    std::future<void> done = task.get_future();
+    RenderCommand cmd;
+    cmd.task = [&task] { task(); };
+    impl_->post(std::move(cmd));
+    done.get();
+}
+
+// ---------------------------------------------------------------------------
+// Render thread
+// ---------------------------------------------------------------------------
+
+void VideoRenderer::start_render_thread() {
+    if (impl_->render_thread_running) return;
+    // The context moves to the render thread; GLFW events stay here.
+    glfwMakeContextCurrent(nullptr);
+    impl_->render_thread_running = true;
+    impl_->render_thread = std::thread(&VideoRendererImpl::render_loop, impl_.get());
+}
+
+void VideoRenderer::stop_render_thread() {
+    if (!impl_->render_thread_running.exchange(false)) return;
+    impl_->render_thread.join();
+    // Commands posted after the last frame still apply, e.g. a final clear_slot().
+    glfwMakeContextCurrent(impl_->windows[0]->window);
+    RenderCommand cmd;
+    while (impl_->commands.pop(cmd)) impl_->apply(cmd);
+}
+
+void VideoRenderer::wait_events(double timeout_s) {
+    glfwWaitEventsTimeout(timeout_s);
+}
+
+void VideoRenderer::set_focus(int slot) {
+    RenderCommand cmd;
+    cmd.type  = RenderCommand::Type::SetFocus;
+    cmd.value = (slot >= 0 && slot < slot_count()) ? slot : -1;
+    impl_->post(std::move(cmd));
+}
+
+void VideoRenderer::set_upload_budget(double ms, double megabytes) {
+    impl_->upload_budget_ns.store(ms > 0 ? static_cast<int64_t>(ms * 1e6) : 0, std::memory_order_relaxed);
+    impl_->upload_budget_bytes.store(megabytes > 0 ? static_cast<int64_t>(megabytes * 1024 * 1024) : -1,
+                                     std::memory_order_relaxed);
+}
+
+uint64_t VideoRenderer::uploads_deferred() const {
+    return impl_->uploads_deferred.load(std::memory_order_relaxed);
+}
+
+double VideoRenderer::frame_period_ms() const {
+    return impl_->frame_period_ms.load(std::memory_order_relaxed);
+}
+
+void VideoRendererImpl::render_loop() {
+    glfwMakeContextCurrent(windows[0]->window);
+    while (render_thread_running.load(std::memory_order_relaxed)) render_frame();
+    glfwMakeContextCurrent(nullptr);
+}
+
+// Main thread. Without a render thread the main thread owns the context, so
+// the command runs at once; otherwise a full queue is drained within a frame.
+void VideoRendererImpl::post(RenderCommand&& cmd) {
+    if (!render_thread_running) {
+        apply(cmd);
+        return;
+    }
+    while (!commands.push(std::move(cmd))) std::this_thread::yield();
+}
+
+// GL context current.
+void VideoRendererImpl::apply(RenderCommand& cmd) {
+    switch (cmd.type) {
+        case RenderCommand::Type::SetColumns: {
+            RenderWindow& w = *windows[cmd.window];
+            w.set_grid(std::min(cmd.value, std::max((int)w.slots.size(), 1)));
+            break;
+        }
+        case RenderCommand::Type::ClearSlot:
+            clear(*slots[cmd.value]);
+            break;
+        case RenderCommand::Type::SetFocus:
+            focused_slot = cmd.value;
+            break;
+        case RenderCommand::Type::FocusAt: {
+            // Clicking the focused cell again gives up focus.
+            const RenderWindow& w = *windows[cmd.window];
+            const int col  = std::min(w.grid_cols - 1, std::max(0, (int)(cmd.x * w.grid_cols)));
+            const int row  = std::min(w.grid_rows - 1, std::max(0, (int)(cmd.y * w.grid_rows)));
+            const int cell = row * w.grid_cols + col;
+            if (cell < (int)w.slots.size())
+                focused_slot = (focused_slot == w.slots[cell]) ? -1 : w.slots[cell];
+            break;
+        }
+        case RenderCommand::Type::Task:
+            cmd.task();
+            break;
+    }
+}
+
+void VideoRendererImpl::clear(StreamSlot& s) {
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        for (QueuedFrame& f : s.queue) recycle(s, f);
+        s.queue.clear();
+        s.clock_valid       = false;  // the next stream has its own timeline
+        s.last_pts_ns       = -1;
+        s.frame_interval_ns = 0;
+    }
+    release_external(s);
+    s.content = SlotContent::Empty;  // textures are kept for the next stream
 }
 
 bool VideoRenderer::should_close() const {
-    return glfwWindowShouldClose(impl_->window);
+    for (const auto& w : impl_->windows)
+        if (glfwWindowShouldClose(w->window)) return true;
+    return false;
 }
 
-void VideoRenderer::render() {
-    int fb_w, fb_h;
-    glfwGetFramebufferSize(impl_->window, &fb_w, &fb_h);
+// Primary context. Takes the slot's due frame and makes it the slot's content.
+bool VideoRendererImpl::update_slot(StreamSlot& s, int64_t now_ns, UploadBudget& budget) {
+    // The back texture is free once the draws that sampled it are done.
+    // Polled, never waited for: with vsync that is normally a frame ago.
+    GLsync& back_free = s.tex_free[1 - s.front];
+    if (back_free && glClientWaitSync(back_free, 0, 0) != GL_TIMEOUT_EXPIRED) {
+        glDeleteSync(back_free);
+        back_free = nullptr;
+    }
+
+    // Take the newest frame that is due; older due frames are superseded
+    // before their turn (brief lock, no GL inside the lock). An upload the
+    // budget cannot cover, or with the GPU still reading the back texture,
+    // stays queued: next frame takes whatever is newest.
+    QueuedFrame next;
+    bool        have_next = false;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        size_t due = 0;
+        while (due < s.queue.size() && s.queue[due].present_ns <= now_ns) ++due;
+        if (due > 0 && s.queue[due - 1].kind == QueuedFrame::Kind::Rgb &&
+            (back_free || !budget.allows(s.queue[due - 1].rgb.size()))) {
+            uploads_deferred.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (due > 0) {
+            for (size_t k = 0; k + 1 < due; ++k) recycle(s, s.queue[k]);
+            next      = std::move(s.queue[due - 1]);
+            have_next = true;
+            s.queue.erase(s.queue.begin(), s.queue.begin() + due);
+            if (next.kind == QueuedFrame::Kind::Rgb) {
+                s.upload_frame.swap(next.rgb);
+                recycle(s, next);  // the previously shown buffer
+            }
+        }
+    }
+    if (!have_next) return true;
+
+    if (next.kind == QueuedFrame::Kind::Dmabuf) {
+        show_dmabuf(s, std::move(next.dmabuf));  // failure: keep old content
+    } else if (next.kind == QueuedFrame::Kind::Texture) {
+        show_texture(s, std::move(next.texture));
+    } else {
+        release_external(s);
+        upload_rgb(s, next);
+        budget.charge(s.upload_frame.size());
+    }
+    return true;
+}
+
+// Primary context; tex[1 - front] is free. Uploads s.upload_frame into it and
+// makes it the front texture.
+void VideoRendererImpl::upload_rgb(StreamSlot& s, const QueuedFrame& frame) {
+    const int back = 1 - s.front;
+    glBindTexture(GL_TEXTURE_2D, s.tex[back]);
+    if (frame.width != s.tex_width[back] || frame.height != s.tex_height[back]) {
+        if (tex_storage) {
+            // Immutable storage cannot be resized: start a new texture. The
+            // driver keeps the old one alive for draws still in flight.
+            if (s.tex_width[back]) {
+                glDeleteTextures(1, &s.tex[back]);
+                s.tex[back] = create_texture();
+            }
+            tex_storage(GL_TEXTURE_2D, 1, GL_RGB8, frame.width, frame.height);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, frame.width, frame.height, 0,
+                         GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        }
+        s.tex_width[back]  = frame.width;
+        s.tex_height[back] = frame.height;
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, frame.row_pixels);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, frame.width, frame.height,
+                    GL_RGB, GL_UNSIGNED_BYTE, s.upload_frame.data());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    // Every draw that sampled the old front texture has been issued by now
+    // (other windows' too: render_frame() made this context wait for them),
+    // so this fence marks when it may be written again.
+    const int old = s.front;
+    if (s.tex_width[old]) {
+        if (s.tex_free[old]) glDeleteSync(s.tex_free[old]);
+        s.tex_free[old] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    s.front   = back;
+    s.content = SlotContent::Rgb;
+}
+
+// The window's context is current.
+void VideoRendererImpl::draw_window(RenderWindow& w) {
+    const int fb_w = w.fb_width.load(std::memory_order_relaxed);
+    const int fb_h = w.fb_height.load(std::memory_order_relaxed);
 
     // Clear the whole window once
     glViewport(0, 0, fb_w, fb_h);
     glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    const int cols = impl_->grid_cols;
-    const int rows = impl_->grid_rows;
+    const int cols = w.grid_cols;
+    const int rows = w.grid_rows;
     const int cell_w = fb_w / cols;
     const int cell_h = fb_h / rows;
 
-    glUseProgram(impl_->shader_program);
-    glUniform1i(glGetUniformLocation(impl_->shader_program, "tex"), 0);
+    glUseProgram(shader_program);
+    glUniform1i(glGetUniformLocation(shader_program, "tex"), 0);
     glActiveTexture(GL_TEXTURE0);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    for (int i = 0; i < (int)impl_->slots.size(); ++i) {
-        auto& s = *impl_->slots[i];
-
-        // Upload new frame if available (brief lock, no GL inside the lock)
-        std::vector<uint8_t> upload_buf;
-        int upload_w = 0, upload_h = 0;
-        {
-            std::lock_guard<std::mutex> lock(s.mutex);
-            if (s.frame_dirty) {
-                upload_buf  = s.pending_frame; // copy out
-                upload_w    = s.pending_width;
-                upload_h    = s.pending_height;
-                s.frame_dirty = false;
-            }
-        }
-        if (!upload_buf.empty()) {
-            glBindTexture(GL_TEXTURE_2D, s.texture);
-            if (upload_w != s.tex_width || upload_h != s.tex_height) {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, upload_w, upload_h, 0,
-                             GL_RGB, GL_UNSIGNED_BYTE, upload_buf.data());
-                s.tex_width  = upload_w;
-                s.tex_height = upload_h;
-            } else {
-                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, upload_w, upload_h,
-                                GL_RGB, GL_UNSIGNED_BYTE, upload_buf.data());
-            }
-        }
+    glBindVertexArray(w.vao);
 
-        if (s.tex_width == 0) continue; // no frame received yet
+    for (int i = 0; i < (int)w.slots.size(); ++i) {
+        const StreamSlot& s = *slots[w.slots[i]];
+        if (s.content == SlotContent::Empty) continue; // no frame received yet
 
         // Grid position: row 0 is top of the window.
         // OpenGL viewport Y=0 is the bottom, so row 0 → highest Y.
@@ -268,13 +1087,98 @@ void VideoRenderer::render() {
         int vp_y = (rows - 1 - row) * cell_h;
 
         glViewport(vp_x, vp_y, cell_w, cell_h);
-        glBindTexture(GL_TEXTURE_2D, s.texture);
-        glBindVertexArray(impl_->vao);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
-        glBindVertexArray(0);
+        if (s.content == SlotContent::DmabufNv12) {
+            glUseProgram(nv12_program);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, s.plane_tex[1]);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, s.plane_tex[0]);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+            glUseProgram(shader_program);
+        } else {
+            const GLuint tex = s.content == SlotContent::Rgb    ? s.tex[s.front]
+                             : s.content == SlotContent::Shared ? s.shown_texture.texture
+                                                                : s.plane_tex[0];
+            glBindTexture(GL_TEXTURE_2D, tex);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        }
+    }
+    glBindVertexArray(0);
+}
+
+void VideoRenderer::render() {
+    if (!impl_->render_thread_running) impl_->render_frame();
+}
+
+void VideoRendererImpl::render_frame() {
+    const bool multi = windows.size() > 1;
+
+    // Slots are updated once, in the primary context, however many windows
+    // show them. Before replacing textures, wait for the other windows' draws
+    // of the previous frame: each context has its own command stream.
+    if (multi) glfwMakeContextCurrent(windows[0]->window);
+    for (size_t i = 1; i < windows.size(); ++i) {
+        if (!windows[i]->drawn) continue;
+        glWaitSync(windows[i]->drawn, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(windows[i]->drawn);
+        windows[i]->drawn = nullptr;
+    }
+
+    reap_retired(false);
+
+    RenderCommand cmd;
+    while (commands.pop(cmd)) apply(cmd);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glActiveTexture(GL_TEXTURE0);
+    // Frames are presented against this render's start.
+    const int64_t now_ns = steady_now_ns();
+    if (last_frame_ns) {
+        const double period = (now_ns - last_frame_ns) / 1e6;
+        frame_period_ms.store(0.9 * frame_period_ms.load(std::memory_order_relaxed) + 0.1 * period,
+                              std::memory_order_relaxed);
+    }
+    last_frame_ns = now_ns;
+
+    // Uploads stop once the budget is spent, so the frame still makes its
+    // vblank; the rest wait for the next frame. The focused cell goes first,
+    // then round-robin from the first slot deferred last time, so no stream
+    // is starved however many are dirty.
+    UploadBudget  budget;
+    const int64_t budget_ns = upload_budget_ns.load(std::memory_order_relaxed);
+    budget.deadline_ns = budget_ns > 0 ? now_ns + budget_ns : 0;
+    budget.bytes_left  = upload_budget_bytes.load(std::memory_order_relaxed);
+    const int n = (int)slots.size();
+    if (focused_slot >= 0 && focused_slot < n) update_slot(*slots[focused_slot], now_ns, budget);
+    int first_deferred = -1;
+    for (int k = 0; k < n; ++k) {
+        const int i = (upload_cursor + k) % n;
+        if (i == focused_slot) continue;
+        if (!update_slot(*slots[i], now_ns, budget) && first_deferred < 0) first_deferred = i;
     }
+    if (first_deferred >= 0) upload_cursor = first_deferred;
+    fence_retired();  // frames replaced above (or cleared since the last frame)
 
-    glfwSwapBuffers(impl_->window);
+    // ...and the other windows wait for this frame's uploads and imports.
+    GLsync updated = nullptr;
+    if (multi) {
+        updated = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+    }
+    for (size_t i = 0; i < windows.size(); ++i) {
+        RenderWindow& w = *windows[i];
+        if (i > 0) {
+            glfwMakeContextCurrent(w.window);
+            glWaitSync(updated, 0, GL_TIMEOUT_IGNORED);
+        }
+        draw_window(w);
+        if (i > 0) w.drawn = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glfwSwapBuffers(w.window);
+    }
+    if (multi) {
+        glfwMakeContextCurrent(windows[0]->window);
+        glDeleteSync(updated);
+    }
 }
 
 void VideoRenderer::poll_events() {
@@ -1,27 +1,125 @@
 #pragma once
 
+#include "dmabuf_frame.h"
+
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // All GLFW/OpenGL types are hidden behind PIMPL so that including this header
 // never requires GLFW to be in the include path.
 struct VideoRendererImpl;
 
+// Native handles of the renderer's GL context, for contexts that share its
+// textures (GStreamer GL). Null unless the context is EGL.
+struct GlShareHandles {
+    void* egl_display = nullptr;  // EGLDisplay
+    void* egl_context = nullptr;  // EGLContext
+};
+
+// An RGBA GL_TEXTURE_2D produced by a context sharing the renderer's, e.g.
+// glupload ! glcolorconvert. Render thread: `wait` runs before the texture is
+// first sampled, `done` after the last draw that used it. `keepalive` owns
+// the texture until then.
+struct GlTextureFrame {
+    unsigned int          texture = 0;
+    int                   width   = 0;
+    int                   height  = 0;
+    std::function<void()> wait;
+    std::function<void()> done;
+    std::shared_ptr<void> keepalive;
+};
+
+// One window of a multi-window (video wall) renderer.
+struct WindowSpec {
+    std::string      title   = "RTSP Stream";
+    int              columns = 0;      // 0: near-square grid
+    int              width   = 1280;
+    int              height  = 720;
+    int              monitor = -1;     // ≥ 0: fullscreen on glfwGetMonitors()[monitor]
+    std::vector<int> slots;            // cells, in grid order; empty: every slot
+};
+
 class VideoRenderer {
 public:
     // num_streams determines the grid layout (1→full, 4→2×2, 9→3×3, etc.)
-    explicit VideoRenderer(int num_streams, const std::string& title = "RTSP Stream");
+    // unless columns > 0 fixes the column count.
+    explicit VideoRenderer(int num_streams, const std::string& title = "RTSP Stream",
+                           int columns = 0, int window_width = 1280, int window_height = 720);
+    // Several windows driven by one render(): their contexts share the first
+    // window's textures, so a slot is uploaded once however many windows
+    // (possibly none) show it. The first window's swap paces render().
+    VideoRenderer(int num_streams, const std::vector<WindowSpec>& windows);
     ~VideoRenderer();
 
     // Thread-safe: slot ∈ [0, num_streams). Called from GStreamer streaming thread.
-    void push_frame(int slot, const uint8_t* data, int width, int height);
+    // stride: bytes per row of data, 0 for tightly packed width × 3.
+    // pts_ns: the frame's presentation timestamp, -1 if unknown (shown at once).
+    void push_frame(int slot, const uint8_t* data, int width, int height, int stride = 0,
+                    int64_t pts_ns = -1);
+
+    // Zero-copy path: the frame's DMABuf fds are imported as textures on the
+    // render thread (EGL_EXT_image_dma_buf_import); RGBx-family and NV12.
+    // accepts_dmabuf() is false without an EGL context supporting the import,
+    // and turns false for good after the first failed import; push_dmabuf()
+    // then refuses the frame and the caller maps it and uses push_frame().
+    bool accepts_dmabuf() const;
+    bool push_dmabuf(int slot, DmabufFrame frame, int64_t pts_ns = -1);
+
+    // Shared-context path: frames already uploaded and converted on another
+    // GL thread are drawn from their texture directly. Thread-safe.
+    GlShareHandles share_handles() const;
+    bool push_texture(int slot, GlTextureFrame frame, int64_t pts_ns = -1);
+
+    // Frame pacing. With a latency target > 0, timestamped frames wait in a
+    // short per-slot queue and each render() shows the newest one whose PTS,
+    // mapped onto the local clock, plus the target has come due: steady
+    // motion despite network bursts and frame rates that don't divide the
+    // refresh rate, for that much extra latency. 0 (default) shows the newest
+    // frame at every render(). The queue grows with the target and the
+    // stream's frame rate; targets above kMaxPresentLatencyMs are capped.
+    // Thread-safe.
+    static constexpr int kMaxPresentLatencyMs = 1000;
+    void set_present_latency_ms(int ms);
+
+    // Per-frame cap on CPU → GL uploads (0: none), so many dirty slots cannot
+    // push the frame past its vblank; what does not fit is deferred to the
+    // next frame. The focused slot uploads first, the others round-robin.
+    // Default: 8 ms, no byte cap. Thread-safe.
+    void set_upload_budget(double ms, double megabytes = 0.0);
+    // Uploads put off to a later frame, for budget or because the GPU was
+    // still drawing from the texture they would overwrite.
+    uint64_t uploads_deferred() const;
+
+    int slot_count() const;
+    int window_count() const;
+
+    // Main thread; applied at the start of the next frame. Lock-free: with a
+    // render thread they travel through a single-producer command queue.
+    void set_columns(int columns, int window = 0);  // grid column count (> 0)
+    void clear_slot(int slot);      // blank a cell, e.g. after its stream was removed
+    void set_focus(int slot);       // -1: none. Clicking a cell toggles its focus too.
+    // Main thread: run fn where the GL context is current (the render thread
+    // between frames, else right here) and wait for it, e.g. to wrap the
+    // context for GStreamer GL.
+    void run_in_context(std::function<void()> fn);
 
     // Main-thread only
-    bool should_close() const;
-    void render();       // upload dirty textures, draw grid
+    bool should_close() const;  // any window asked to close
+    void render();       // upload dirty textures, draw grid; no-op with a render thread
     void poll_events();
 
+    // Dedicated render thread: takes over the GL context and loops uploads,
+    // draws and swaps, so vsync waits never hold up event handling or control
+    // requests on the main thread, and those never delay uploads. The main
+    // thread then only services events, e.g. with wait_events().
+    void start_render_thread();
+    void stop_render_thread();  // context returns to the main thread
+    void wait_events(double timeout_s);
+    double frame_period_ms() const;  // smoothed time between rendered frames
+
 private:
     std::unique_ptr<VideoRendererImpl> impl_;
 };